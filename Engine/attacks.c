@@ -0,0 +1,283 @@
+#include "attacks.h"
+#include <stdio.h>
+
+// Macro pour logs de debug conditionnels
+#ifdef DEBUG
+#define DEBUG_LOG(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define DEBUG_LOG(...)
+#endif
+
+// ========== TABLES GLOBALES ==========
+
+// Entrée "magic" pour une case : l'index dans la table d'attaques est
+// ((occupation & mask) * magic) >> shift
+typedef struct {
+  Bitboard mask;     // Cases pouvant bloquer le rayon (bords exclus)
+  Bitboard magic;    // Multiplicateur précalculé, embarqué en constante
+  Bitboard *attacks; // Sous-table d'attaques propre à cette case
+  unsigned shift;    // 64 - nombre de bits de mask
+} Magic;
+
+static Magic rook_magics[64];
+static Magic bishop_magics[64];
+
+// Tailles exactes : somme des 2^bits(mask) sur les 64 cases
+static Bitboard rook_table[102400];
+static Bitboard bishop_table[5248];
+
+static Bitboard pawn_table[2][64]; // [color][square]
+static Bitboard knight_table[64];
+static Bitboard king_table[64];
+static Bitboard between_table[64][64];
+static Bitboard line_table[64][64];
+
+// Directions (rangée, colonne) des pièces glissantes
+static const int rook_directions[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+static const int bishop_directions[4][2] = {
+    {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// ========== CALCULS DE RÉFÉRENCE (INITIALISATION UNIQUEMENT) ==========
+
+// Parcourt les rayons case par case jusqu'au premier obstacle (inclus)
+static Bitboard sliding_attacks(Square square, Bitboard occupied,
+                                const int directions[4][2]) {
+  Bitboard attacks = 0;
+  int rank = square / 8;
+  int file = square % 8;
+
+  for (int d = 0; d < 4; d++) {
+    int r = rank + directions[d][0];
+    int f = file + directions[d][1];
+    while (r >= 0 && r <= 7 && f >= 0 && f <= 7) {
+      Square to = r * 8 + f;
+      SET_BIT(attacks, to);
+      if (GET_BIT(occupied, to))
+        break; // Obstacle rencontré
+      r += directions[d][0];
+      f += directions[d][1];
+    }
+  }
+  return attacks;
+}
+
+// Cases dont l'occupation influence les attaques : les rayons sans la
+// dernière case (une pièce au bord ne bloque rien derrière elle)
+static Bitboard relevant_mask(Square square, const int directions[4][2]) {
+  Bitboard mask = 0;
+  int rank = square / 8;
+  int file = square % 8;
+
+  for (int d = 0; d < 4; d++) {
+    int r = rank + directions[d][0];
+    int f = file + directions[d][1];
+    int next_r = r + directions[d][0];
+    int next_f = f + directions[d][1];
+    while (next_r >= 0 && next_r <= 7 && next_f >= 0 && next_f <= 7) {
+      SET_BIT(mask, r * 8 + f);
+      r = next_r;
+      f = next_f;
+      next_r += directions[d][0];
+      next_f += directions[d][1];
+    }
+  }
+  return mask;
+}
+
+// ========== MAGICS ==========
+
+// Multiplicateurs sans collision destructive, obtenus hors ligne par
+// recherche aléatoire (candidats creux : rand & rand & rand)
+static const Bitboard rook_magic_numbers[64] = {
+    0x0A80004000801220ULL, 0x8040004010002008ULL, 0x2080200010008008ULL,
+    0x1100100008210004ULL, 0xC200209084020008ULL, 0x2100010004000208ULL,
+    0x0400081000822421ULL, 0x0200010422048844ULL, 0x0800800080400024ULL,
+    0x0001402000401000ULL, 0x3000801000802001ULL, 0x4400800800100083ULL,
+    0x0904802402480080ULL, 0x4040800400020080ULL, 0x0018808042000100ULL,
+    0x4040800080004100ULL, 0x0040048001458024ULL, 0x00A0004000205000ULL,
+    0x3100808010002000ULL, 0x4825010010000820ULL, 0x5004808008000401ULL,
+    0x2024818004000A00ULL, 0x0005808002000100ULL, 0x2100060004806104ULL,
+    0x0080400880008421ULL, 0x4062220600410280ULL, 0x010A004A00108022ULL,
+    0x0000100080080080ULL, 0x0021000500080010ULL, 0x0044000202001008ULL,
+    0x0000100400080102ULL, 0xC020128200040545ULL, 0x0080002000400040ULL,
+    0x0000804000802004ULL, 0x0000120022004080ULL, 0x010A386103001001ULL,
+    0x9010080080800400ULL, 0x8440020080800400ULL, 0x0004228824001001ULL,
+    0x000000490A000084ULL, 0x0080002000504000ULL, 0x200020005000C000ULL,
+    0x0012088020420010ULL, 0x0010010080080800ULL, 0x0085001008010004ULL,
+    0x0002000204008080ULL, 0x0040413002040008ULL, 0x0000304081020004ULL,
+    0x0080204000800080ULL, 0x3008804000290100ULL, 0x1010100080200080ULL,
+    0x2008100208028080ULL, 0x5000850800910100ULL, 0x8402019004680200ULL,
+    0x0120911028020400ULL, 0x0000008044010200ULL, 0x0020850200244012ULL,
+    0x0020850200244012ULL, 0x0000102001040841ULL, 0x140900040A100021ULL,
+    0x000200282410A102ULL, 0x000200282410A102ULL, 0x000200282410A102ULL,
+    0x4048240043802106ULL,
+};
+
+static const Bitboard bishop_magic_numbers[64] = {
+    0x9060124418008010ULL, 0x0020010250810120ULL, 0x2010010220280081ULL,
+    0x002806004050C040ULL, 0x0002021018000000ULL, 0x2001112010000400ULL,
+    0x0881010120218080ULL, 0x1030820110010500ULL, 0x0000120222042400ULL,
+    0x2000020404040044ULL, 0x8000480094208000ULL, 0x0003422A02000001ULL,
+    0x000A220210100040ULL, 0x8004820202226000ULL, 0x0018234854100800ULL,
+    0x0100004042101040ULL, 0x0004001004082820ULL, 0x0010000810010048ULL,
+    0x1014004208081300ULL, 0x2080818802044202ULL, 0x0040880C00A00100ULL,
+    0x0080400200522010ULL, 0x0001000188180B04ULL, 0x0080249202020204ULL,
+    0x1004400004100410ULL, 0x00013100A0022206ULL, 0x2148500001040080ULL,
+    0x4241080011004300ULL, 0x4020848004002000ULL, 0x10101380D1004100ULL,
+    0x0008004422020284ULL, 0x01010A1041008080ULL, 0x0808080400082121ULL,
+    0x0808080400082121ULL, 0x0091128200100C00ULL, 0x0202200802010104ULL,
+    0x8C0A020200440085ULL, 0x01A0008080B10040ULL, 0x0889520080122800ULL,
+    0x100902022202010AULL, 0x04081A0816002000ULL, 0x0000681208005000ULL,
+    0x8170840041008802ULL, 0x0A00004200810805ULL, 0x0830404408210100ULL,
+    0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+    0x0602010120110040ULL, 0x0941010801043000ULL, 0x000040440A210428ULL,
+    0x0008240020880021ULL, 0x0400002012048200ULL, 0x00AC102001210220ULL,
+    0x0220021002009900ULL, 0x84440C080A013080ULL, 0x0001008044200440ULL,
+    0x0004C04410841000ULL, 0x2000500104011130ULL, 0x1A0C010011C20229ULL,
+    0x0044800112202200ULL, 0x0434804908100424ULL, 0x0300404822C08200ULL,
+    0x48081010008A2A80ULL,
+};
+
+// Remplit la table d'attaques de chaque case à partir de son magic
+static void init_magics(Magic magics[64], Bitboard *table,
+                        const Bitboard magic_numbers[64],
+                        const int directions[4][2]) {
+  Bitboard *next = table;
+
+  for (Square square = A1; square <= H8; square++) {
+    Magic *m = &magics[square];
+    m->mask = relevant_mask(square, directions);
+    m->magic = magic_numbers[square];
+    m->shift = 64 - __builtin_popcountll(m->mask);
+    m->attacks = next;
+
+    // Énumère tous les sous-ensembles du masque (Carry-Rippler)
+    int size = 0;
+    Bitboard subset = 0;
+    do {
+      Bitboard attacks = sliding_attacks(square, subset, directions);
+      unsigned index = (unsigned)((subset * m->magic) >> m->shift);
+#ifdef DEBUG
+      // Une collision n'est tolérée que si les attaques sont identiques
+      if (m->attacks[index] != 0 && m->attacks[index] != attacks) {
+        DEBUG_LOG("[ATTACKS] Magic invalide pour la case %d\n", square);
+      }
+#endif
+      m->attacks[index] = attacks;
+      size++;
+      subset = (subset - m->mask) & m->mask;
+    } while (subset);
+    next += size;
+  }
+}
+
+// ========== PIÈCES SAUTANTES ET PIONS ==========
+
+// Ajoute la case (rank, file) si elle est sur l'échiquier
+static void add_if_on_board(Bitboard *bb, int rank, int file) {
+  if (rank >= 0 && rank <= 7 && file >= 0 && file <= 7)
+    SET_BIT(*bb, rank * 8 + file);
+}
+
+static void init_leaper_tables(void) {
+  static const int knight_offsets[8][2] = {{2, 1},   {2, -1}, {-2, 1},
+                                           {-2, -1}, {1, 2},  {1, -2},
+                                           {-1, 2},  {-1, -2}};
+
+  for (Square square = A1; square <= H8; square++) {
+    int rank = square / 8;
+    int file = square % 8;
+
+    // Pions : captures en diagonale vers l'avant de chaque couleur
+    pawn_table[WHITE][square] = 0;
+    pawn_table[BLACK][square] = 0;
+    add_if_on_board(&pawn_table[WHITE][square], rank + 1, file - 1);
+    add_if_on_board(&pawn_table[WHITE][square], rank + 1, file + 1);
+    add_if_on_board(&pawn_table[BLACK][square], rank - 1, file - 1);
+    add_if_on_board(&pawn_table[BLACK][square], rank - 1, file + 1);
+
+    knight_table[square] = 0;
+    for (int i = 0; i < 8; i++) {
+      add_if_on_board(&knight_table[square], rank + knight_offsets[i][0],
+                      file + knight_offsets[i][1]);
+    }
+
+    king_table[square] = 0;
+    for (int dr = -1; dr <= 1; dr++) {
+      for (int df = -1; df <= 1; df++) {
+        if (dr != 0 || df != 0)
+          add_if_on_board(&king_table[square], rank + dr, file + df);
+      }
+    }
+  }
+}
+
+// ========== GÉOMÉTRIE ==========
+
+// Doit être appelée après init_magics (utilise les attaques glissantes)
+static void init_line_tables(void) {
+  for (Square a = A1; a <= H8; a++) {
+    for (Square b = A1; b <= H8; b++) {
+      between_table[a][b] = 0;
+      line_table[a][b] = 0;
+      if (a == b)
+        continue;
+
+      Bitboard bit_a = 1ULL << a;
+      Bitboard bit_b = 1ULL << b;
+      if (rook_attacks(a, 0) & bit_b) {
+        line_table[a][b] = (rook_attacks(a, 0) & rook_attacks(b, 0)) | bit_a |
+                           bit_b;
+        between_table[a][b] = rook_attacks(a, bit_b) & rook_attacks(b, bit_a);
+      } else if (bishop_attacks(a, 0) & bit_b) {
+        line_table[a][b] = (bishop_attacks(a, 0) & bishop_attacks(b, 0)) |
+                           bit_a | bit_b;
+        between_table[a][b] =
+            bishop_attacks(a, bit_b) & bishop_attacks(b, bit_a);
+      }
+    }
+  }
+}
+
+// ========== INITIALISATION ==========
+
+void init_attack_tables(void) {
+  static int initialized = 0;
+  if (initialized)
+    return; // Tables indépendantes de la partie : une seule fois suffit
+
+  init_leaper_tables();
+  init_magics(rook_magics, rook_table, rook_magic_numbers, rook_directions);
+  init_magics(bishop_magics, bishop_table, bishop_magic_numbers,
+              bishop_directions);
+  init_line_tables();
+  initialized = 1;
+}
+
+// ========== ATTAQUES ==========
+
+Bitboard pawn_attacks(Couleur color, Square square) {
+  return pawn_table[color][square];
+}
+
+Bitboard knight_attacks(Square square) { return knight_table[square]; }
+
+Bitboard king_attacks(Square square) { return king_table[square]; }
+
+Bitboard rook_attacks(Square square, Bitboard occupied) {
+  const Magic *m = &rook_magics[square];
+  return m->attacks[((occupied & m->mask) * m->magic) >> m->shift];
+}
+
+Bitboard bishop_attacks(Square square, Bitboard occupied) {
+  const Magic *m = &bishop_magics[square];
+  return m->attacks[((occupied & m->mask) * m->magic) >> m->shift];
+}
+
+Bitboard queen_attacks(Square square, Bitboard occupied) {
+  return rook_attacks(square, occupied) | bishop_attacks(square, occupied);
+}
+
+Bitboard between_squares(Square a, Square b) { return between_table[a][b]; }
+
+Bitboard line_through(Square a, Square b) { return line_table[a][b]; }
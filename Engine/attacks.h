@@ -0,0 +1,26 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "board.h"
+
+// Initialise les tables d'attaques (à appeler une seule fois au démarrage)
+void init_attack_tables(void);
+
+// Attaques des pièces sautantes et des pions (tables précalculées)
+Bitboard pawn_attacks(Couleur color, Square square);
+Bitboard knight_attacks(Square square);
+Bitboard king_attacks(Square square);
+
+// Attaques des pièces glissantes pour une occupation donnée
+// (une seule lecture de table par appel)
+Bitboard rook_attacks(Square square, Bitboard occupied);
+Bitboard bishop_attacks(Square square, Bitboard occupied);
+Bitboard queen_attacks(Square square, Bitboard occupied);
+
+// Géométrie entre deux cases alignées (0 si non alignées)
+// between_squares : cases strictement entre a et b
+// line_through    : ligne complète (bords inclus) passant par a et b
+Bitboard between_squares(Square a, Square b);
+Bitboard line_through(Square a, Square b);
+
+#endif // ATTACKS_H
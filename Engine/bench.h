@@ -0,0 +1,19 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// Paramètres par défaut de "bench [depth] [threads] [hash]"
+#define BENCH_DEFAULT_DEPTH 9
+#define BENCH_DEFAULT_THREADS 1
+#define BENCH_DEFAULT_HASH_MB 16
+
+// Cherche chaque position du jeu intégré à profondeur fixe, table de
+// transposition et historiques vidés avant chacune, puis affiche le total de
+// noeuds (signature déterministe de la recherche avec un seul thread), le
+// temps écoulé et les NPS. Retourne le total de noeuds. Le nombre de threads
+// et la table restent ceux du bench, MultiPV vaut 1 : l'appelant rétablit
+// ses options
+uint64_t bench_run(int depth, int threads, int hash_mb);
+
+#endif // BENCH_H
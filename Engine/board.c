@@ -1,5 +1,6 @@
 // board.c
 #include "board.h"
+#include "zobrist.h"
 #include <assert.h>
 #include <ctype.h>
 #include <stdio.h>
@@ -48,42 +49,65 @@ void board_init(Board *board) {
   board->to_move = WHITE;
   board->castle_rights = 0xF; // Tous les roques possibles : 0b1111 donc 4 bits
                               // pour les 4 roques possibles (blancs et noirs).
-  board->en_passant = -1;
+  board->en_passant = NO_SQUARE;
   board->halfmove_clock = 0;
   board->move_number = 1;
+  board_sync_mailbox(board);
+  board->zobrist_key = zobrist_hash(board);
 }
 
-bool is_square_occupied(const Board *board, Square square) {
-  return GET_BIT(board->all_pieces, square);
-}
+// ========== MAILBOX ==========
 
-Couleur get_piece_color(const Board *board, Square square) {
+void board_sync_mailbox(Board *board) {
+  memset(board->piece_on, NO_PIECE, sizeof(board->piece_on));
+  for (Couleur couleur = WHITE; couleur <= BLACK; couleur++) {
+    for (PieceType type = PAWN; type <= KING; type++) {
+      Bitboard pieces = board->pieces[couleur][type];
+      while (pieces) {
+        board->piece_on[__builtin_ctzll(pieces)] = MAKE_PIECE(couleur, type);
+        pieces &= pieces - 1;
+      }
+    }
+  }
+}
 
-  if (!is_square_occupied(board, square)) {
-    return NO_COLOR; // Retourne NO_COLOR pour case vide
+bool board_mailbox_consistent(const Board *board) {
+  for (Square square = A1; square <= H8; square++) {
+    int8_t piece = board->piece_on[square];
+    if (piece == NO_PIECE) {
+      if (GET_BIT(board->all_pieces, square))
+        return false;
+    } else if (!GET_BIT(board->pieces[PIECE_COLOR_OF(piece)]
+                                     [PIECE_TYPE_OF(piece)],
+                        square) ||
+               !GET_BIT(board->occupied[PIECE_COLOR_OF(piece)], square)) {
+      return false;
+    }
   }
-  if (GET_BIT(board->occupied[WHITE], square)) {
-    return WHITE;
-  } else {
-    return BLACK;
+  // Chaque case occupée a été vue ci-dessus : il reste à exclure une pièce
+  // présente dans deux bitboards
+  int count = 0;
+  for (Couleur couleur = WHITE; couleur <= BLACK; couleur++) {
+    for (PieceType type = PAWN; type <= KING; type++) {
+      count += __builtin_popcountll(board->pieces[couleur][type]);
+    }
   }
+  return count == __builtin_popcountll(board->all_pieces);
 }
-PieceType get_piece_type(const Board *board, Square square) {
 
-  // 1. Vérification de sécurité
-  if (!is_square_occupied(board, square))
-    return EMPTY;
+bool is_square_occupied(const Board *board, Square square) {
+  return GET_BIT(board->all_pieces, square);
+}
 
-  // 2. Déterminer la couleur (cela permet de réduire la boucle du test de type
-  // à 6 au lieu de 12)
-  Couleur couleur = get_piece_color(board, square);
+// Lecture directe de la mailbox
+Couleur get_piece_color(const Board *board, Square square) {
+  int8_t piece = board->piece_on[square];
+  return (piece == NO_PIECE) ? NO_COLOR : PIECE_COLOR_OF(piece);
+}
 
-  // 3. Boucle sur les types
-  for (PieceType type = PAWN; type <= KING; type++) {
-    if (GET_BIT(board->pieces[couleur][type], square))
-      return type;
-  }
-  return EMPTY; // Impossible mais petite sécurité au cas où
+PieceType get_piece_type(const Board *board, Square square) {
+  int8_t piece = board->piece_on[square];
+  return (piece == NO_PIECE) ? EMPTY : PIECE_TYPE_OF(piece);
 }
 
 char get_piece_char(const Board *board, Square square) {
@@ -154,6 +178,7 @@ const char *parse_fen_pieces(Board *board, const char *fen) {
     }
   }
   board->all_pieces = board->occupied[WHITE] | board->occupied[BLACK];
+  board_sync_mailbox(board);
 
   // Avancer jusqu’au premier espace
   while (*fen && *fen != ' ')
@@ -210,7 +235,7 @@ const char *parse_fen_castling(Board *board, const char *fen) {
 
 const char *parse_fen_en_passant(Board *board, const char *fen) {
   if (*fen == '-') {
-    board->en_passant = -1;
+    board->en_passant = NO_SQUARE;
   } else if (*fen >= 'a' && *fen <= 'h' && *(fen + 1) >= '1' &&
              *(fen + 1) <= '8') {
     int file = *fen - 'a';
@@ -218,7 +243,7 @@ const char *parse_fen_en_passant(Board *board, const char *fen) {
     board->en_passant = rank * 8 + file;
     fen++;
   } else {
-    board->en_passant = -1;
+    board->en_passant = NO_SQUARE;
   }
   return fen + 1; // Passer espace ou caractère suivant
 }
@@ -232,20 +257,16 @@ void board_from_fen(Board *board, const char *fen) {
   memset(board, 0, sizeof(Board));
 
   const char *current = parse_fen_pieces(board, fen);
-  if (!current)
-    return;
-
-  current = parse_fen_side_to_move(board, current);
-  if (!current)
-    return;
-
-  current = parse_fen_castling(board, current);
-  if (!current)
-    return;
-
-  current = parse_fen_en_passant(board, current);
-  if (!current)
-    return;
-
-  reset_move_counters(board);
+  if (current)
+    current = parse_fen_side_to_move(board, current);
+  if (current)
+    current = parse_fen_castling(board, current);
+  if (current)
+    current = parse_fen_en_passant(board, current);
+  if (current)
+    reset_move_counters(board);
+
+  // Clé calculée une seule fois ici (même pour un FEN incomplet) ;
+  // make_move la met ensuite à jour par différences
+  board->zobrist_key = zobrist_hash(board);
 }
@@ -77,7 +77,8 @@ typedef enum {
   E8,
   F8,
   G8,
-  H8
+  H8,
+  NO_SQUARE = -1 // Aucune case (ex: pas de prise en passant)
 } Square;
 
 // Constantes pour les droits de roque (bitfield)
@@ -109,16 +110,33 @@ typedef struct {
   Square en_passant;
   // Case ou il est possible de capturer grâce à la règle "en passant"
   // (ex: le pion blanc va de E2 vers E4 => en_passant = E3)
-  // -1 si aucun en passant possible
+  // NO_SQUARE si aucun en passant possible
   int halfmove_clock; // A INTEGRER DANS LE GUI
   // Compteur de demi-coups (1 action = 1 demi-coup)
   // Sert à la règle des 50 coups : remis à 0 après un pion joué ou une capture
   int move_number; // Numérote le nombre de coup de la partie
+  int8_t piece_on[64];
+  // Mailbox redondante avec les bitboards : pièce de chaque case codée
+  // (couleur << 3) | type, NO_PIECE si vide (lecture d'un seul octet)
+  uint64_t zobrist_key;
+  // Clé Zobrist de la position, tenue à jour par make_move (XOR des
+  // seules différences) au lieu d'être recalculée à chaque noeud
 } Board;
 
+// Codage des cases de la mailbox (piece_on)
+#define NO_PIECE (-1)
+#define MAKE_PIECE(couleur, type) ((int8_t)(((couleur) << 3) | (type)))
+#define PIECE_TYPE_OF(piece) ((PieceType)((piece) & 7))
+#define PIECE_COLOR_OF(piece) ((Couleur)((piece) >> 3))
+
 // Fonctions de base à intégrer dans un bitboard
 void board_init(Board *board);
 
+// Reconstruit piece_on à partir des bitboards (après une mise en place)
+void board_sync_mailbox(Board *board);
+// Vérifie que mailbox et bitboards décrivent la même position (debug)
+bool board_mailbox_consistent(const Board *board);
+
 void board_from_fen(
     Board *board,
     const char *fen); // Initialise le plateau à partir d'une chaîne FEN
@@ -1,10 +1,23 @@
+#include "bench.h"
 #include "search.h"
 #include "uci.h"
+#include <stdlib.h>
+#include <string.h>
 
 // main.c
-int main() {
+int main(int argc, char **argv) {
   init_zobrist();
   initialize_engine();
+
+  // "chess_engine bench [depth] [threads] [hash]" : bench puis sortie
+  if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+    int depth = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_DEPTH;
+    int threads = argc > 3 ? atoi(argv[3]) : BENCH_DEFAULT_THREADS;
+    int hash_mb = argc > 4 ? atoi(argv[4]) : BENCH_DEFAULT_HASH_MB;
+    bench_run(depth, threads, hash_mb);
+    return 0;
+  }
+
   uci_loop();
   return 0;
 }
@@ -10,33 +10,40 @@
 #define DEBUG_LOG(...)
 #endif
 
+// Default version if not specified (même valeur que search.c)
+#ifndef VERSION
+#define VERSION 10
+#endif
+
 // ========== TABLES GLOBALES ==========
 
-static Move killer_moves[128][2];     // [ply][killer_slot]
-static int history_scores[2][64][64]; // [color][from][to]
+// Tables du thread de recherche courant (Lazy SMP) : elles appartiennent à
+// son état et sont conservées d'une recherche à l'autre
+static _Thread_local OrderingTables *ordering;
 
 // ========== INITIALISATION ==========
 
-void init_killer_moves(void) {
-  memset(killer_moves, 0, sizeof(killer_moves));
-  memset(history_scores, 0, sizeof(history_scores));
+void init_killer_moves(OrderingTables *tables) {
+  memset(tables, 0, sizeof(OrderingTables));
 }
 
+void set_ordering_tables(OrderingTables *tables) { ordering = tables; }
+
 // ========== MVV-LVA ==========
 
-int mvv_lva_score(const Move *move) {
-  if (move->type != MOVE_CAPTURE && move->type != MOVE_EN_PASSANT) {
+int mvv_lva_score(const Board *board, const Move *move) {
+  if (!MOVE_IS_CAPTURE(*move)) {
     return 0;
   }
 
   // Valeurs des pièces pour MVV-LVA
   static const int piece_values[] = {100, 320, 330, 500, 900, 20000};
 
-  int victim_value = piece_values[move->captured_piece];
+  int victim_value = piece_values[move_captured_piece(board, *move)];
 
   // Pour l'attaquant, approximation basée sur les promotions
   int attacker_value = 100; // Pion par défaut
-  if (move->type == MOVE_PROMOTION) {
+  if (MOVE_IS_PROMOTION(*move)) {
     attacker_value = 100; // C'est un pion qui promeut
   }
 
@@ -51,15 +58,14 @@ void store_killer_move(Move move, int ply) {
     return;
 
   // Ne stocker que les coups non-capture comme killer moves
-  if (move.type == MOVE_CAPTURE || move.type == MOVE_EN_PASSANT) {
+  if (MOVE_IS_CAPTURE(move)) {
     return;
   }
 
   // Shift: killer[1] -> killer[0], nouveau -> killer[1]
-  if (killer_moves[ply][0].from != move.from ||
-      killer_moves[ply][0].to != move.to) {
-    killer_moves[ply][1] = killer_moves[ply][0];
-    killer_moves[ply][0] = move;
+  if (ordering->killer_moves[ply][0] != move) {
+    ordering->killer_moves[ply][1] = ordering->killer_moves[ply][0];
+    ordering->killer_moves[ply][0] = move;
   }
 }
 
@@ -67,27 +73,27 @@ int is_killer_move(Move move, int ply) {
   if (ply >= 128)
     return 0;
 
-  return ((killer_moves[ply][0].from == move.from &&
-           killer_moves[ply][0].to == move.to) ||
-          (killer_moves[ply][1].from == move.from &&
-           killer_moves[ply][1].to == move.to));
+  return ordering->killer_moves[ply][0] == move ||
+         ordering->killer_moves[ply][1] == move;
 }
 
 // ========== HISTORY HEURISTIC ==========
 
 void update_history(Move move, int depth, Couleur color) {
-  if (move.type == MOVE_CAPTURE || move.type == MOVE_EN_PASSANT) {
+  if (MOVE_IS_CAPTURE(move)) {
     return; // Pas d'historique pour les captures
   }
 
-  history_scores[color][move.from][move.to] += depth * depth;
+  Square from = MOVE_FROM(move);
+  Square to = MOVE_TO(move);
+  ordering->history_scores[color][from][to] += depth * depth;
 
   // Éviter overflow
-  if (history_scores[color][move.from][move.to] > 10000) {
+  if (ordering->history_scores[color][from][to] > 10000) {
     // Diviser tous les scores par 2
     for (int i = 0; i < 64; i++) {
       for (int j = 0; j < 64; j++) {
-        history_scores[color][i][j] /= 2;
+        ordering->history_scores[color][i][j] /= 2;
       }
     }
   }
@@ -95,31 +101,76 @@ void update_history(Move move, int depth, Couleur color) {
 
 // ========== SEE (Static Exchange Evaluation) ==========
 
-static int see_capture(const Board *board, const Move *move) {
-  if (move->type != MOVE_CAPTURE && move->type != MOVE_EN_PASSANT) {
+// Échange complet sur la case d'arrivée : chaque camp reprend avec sa pièce
+// la moins précieuse, les rayons X sont révélés en retirant les pièces de
+// l'occupation, et chaque camp peut s'arrêter quand l'échange lui coûte
+int see_capture(const Board *board, const Move *move) {
+  if (!MOVE_IS_CAPTURE(*move) && !MOVE_IS_PROMOTION(*move)) {
     return 0;
   }
 
-  Square to = move->to;
-  int gain = piece_value(move->captured_piece);
+  Square from = MOVE_FROM(*move);
+  Square to = MOVE_TO(*move);
+  Bitboard occupancy = board->all_pieces ^ (1ULL << from);
+  PieceType victim = get_piece_type(board, from);
+  PieceType captured = move_captured_piece(board, *move);
+  int gain[32];
+  int depth = 0;
+
+  gain[0] = (captured != EMPTY) ? piece_value(captured) : 0;
+  if (MOVE_TYPE(*move) == MOVE_EN_PASSANT) {
+    Square captured_square = (board->to_move == WHITE) ? to - 8 : to + 8;
+    occupancy ^= 1ULL << captured_square;
+  } else if (MOVE_IS_PROMOTION(*move)) {
+    gain[0] += piece_value(MOVE_PROMOTION_PIECE(*move)) - piece_value(PAWN);
+    victim = MOVE_PROMOTION_PIECE(*move);
+  }
 
-  // Approximation simple : si l'attaquant peut être recapturé
-  Couleur attacking_color = board->to_move;
-  Couleur defending_color = (attacking_color == WHITE) ? BLACK : WHITE;
+  Couleur side = (board->to_move == WHITE) ? BLACK : WHITE;
+  Bitboard attackers = attackers_to(board, to, occupancy) & occupancy;
+
+  while (depth < 31) {
+    Bitboard side_attackers = attackers & board->occupied[side];
+    if (!side_attackers)
+      break;
+
+    // Attaquant le moins précieux
+    PieceType attacker = PAWN;
+    Bitboard candidates = 0;
+    for (; attacker <= KING; attacker++) {
+      candidates = side_attackers & board->pieces[side][attacker];
+      if (candidates)
+        break;
+    }
+    Bitboard attacker_bb = candidates & -candidates;
+
+    // Le roi ne reprend que si la case n'est plus défendue
+    if (attacker == KING) {
+      Couleur other = (side == WHITE) ? BLACK : WHITE;
+      Bitboard remaining = attackers_to(board, to, occupancy ^ attacker_bb) &
+                           (occupancy ^ attacker_bb) & board->occupied[other];
+      if (remaining)
+        break;
+    }
 
-  // Si la case de destination est défendue par l'adversaire
-  if (is_square_attacked(board, to, defending_color)) {
-    int attacker_value = 0;
+    depth++;
+    gain[depth] = piece_value(victim) - gain[depth - 1];
 
-    // Déterminer la valeur de l'attaquant
-    PieceType attacker = get_piece_type(board, move->from);
-    attacker_value = piece_value(attacker);
+    occupancy ^= attacker_bb;
+    attackers = attackers_to(board, to, occupancy) & occupancy;
+    victim = attacker;
+    side = (side == WHITE) ? BLACK : WHITE;
+  }
 
-    // Gain net approximatif = valeur_capturée - valeur_attaquant
-    gain = gain - attacker_value;
+  // Remontée : chaque camp choisit entre reprendre et s'arrêter
+  while (depth > 0) {
+    int continue_score = -gain[depth];
+    if (continue_score < gain[depth - 1])
+      gain[depth - 1] = continue_score;
+    depth--;
   }
 
-  return gain;
+  return gain[0];
 }
 
 // ========== ORDONNANCEMENT DES COUPS ==========
@@ -134,12 +185,12 @@ void order_moves(const Board *board, MoveList *moves, OrderedMoveList *ordered,
     int score = 0;
 
     // 1. Hash move (priorité maximale)
-    if (hash_move.from == move->from && hash_move.to == move->to) {
+    if (hash_move == *move) {
       score = 1000000;
     }
     // 2. Captures (MVV-LVA)
-    else if (move->type == MOVE_CAPTURE || move->type == MOVE_EN_PASSANT) {
-      score = 100000 + mvv_lva_score(move);
+    else if (MOVE_IS_CAPTURE(*move)) {
+      score = 100000 + mvv_lva_score(board, move);
     }
 #if VERSION >= 9
     // 3. Killer moves
@@ -150,7 +201,8 @@ void order_moves(const Board *board, MoveList *moves, OrderedMoveList *ordered,
 #if VERSION >= 8
     // 4. History heuristic pour les coups quiet ← CETTE LIGNE MANQUE !
     else {
-      score = history_scores[board->to_move][move->from][move->to];
+      score = ordering->history_scores[board->to_move][MOVE_FROM(*move)]
+                                      [MOVE_TO(*move)];
     }
 #else
     // Sans history : score par défaut
@@ -177,4 +229,224 @@ void order_moves(const Board *board, MoveList *moves, OrderedMoveList *ordered,
       }
     }
   }
-}
\ No newline at end of file
+}
+// ========== SÉLECTEUR DE COUPS PAR ÉTAPES ==========
+
+// Captures, prises en passant et promotions
+static int is_noisy_move(const Move *move) {
+  return MOVE_IS_CAPTURE(*move) || MOVE_IS_PROMOTION(*move);
+}
+
+// MVV-LVA avec l'attaquant réel : victime la plus précieuse d'abord, puis
+// attaquant le moins précieux ; une promotion ajoute la pièce promue
+static int capture_score(const Board *board, const Move *move) {
+  int score = 0;
+  PieceType captured = move_captured_piece(board, *move);
+  if (captured != EMPTY) {
+    score = piece_value(captured) * 8 -
+            (int)get_piece_type(board, MOVE_FROM(*move));
+  }
+  if (MOVE_IS_PROMOTION(*move)) {
+    score += piece_value(MOVE_PROMOTION_PIECE(*move));
+  }
+  return score;
+}
+
+// Tri par sélection partiel : amène le meilleur coup de [begin, end) en
+// begin (un seul passage par coup réellement joué)
+static void select_best(MovePicker *picker, int begin, int end) {
+#if VERSION >= 2
+  int best = begin;
+  for (int i = begin + 1; i < end; i++) {
+    if (picker->scores[i] > picker->scores[best])
+      best = i;
+  }
+  if (best != begin) {
+    Move temp_move = picker->moves[begin];
+    picker->moves[begin] = picker->moves[best];
+    picker->moves[best] = temp_move;
+    int temp_score = picker->scores[begin];
+    picker->scores[begin] = picker->scores[best];
+    picker->scores[best] = temp_score;
+  }
+#else
+  // V1: Pas d'ordonnancement, utiliser l'ordre de génération
+  (void)picker;
+  (void)begin;
+  (void)end;
+#endif
+}
+
+// Génère les coups tactiques en tête de liste avec leur score MVV-LVA
+static void generate_picker_captures(MovePicker *picker) {
+  MoveList noisy_moves;
+  generate_noisy_moves(picker->board, &noisy_moves);
+
+  for (int i = 0; i < noisy_moves.count; i++) {
+    picker->scores[i] = capture_score(picker->board, &noisy_moves.moves[i]);
+    picker->moves[i] = noisy_moves.moves[i];
+  }
+  picker->capture_end = noisy_moves.count;
+  picker->count = noisy_moves.count;
+}
+
+// Les coups calmes ne sont générés qu'une fois captures et killers épuisés
+// (souvent jamais : une coupure arrive avant)
+static void generate_picker_quiets(MovePicker *picker) {
+  MoveList quiet_moves;
+  generate_quiet_moves(picker->board, &quiet_moves);
+
+  picker->count = picker->capture_end;
+  for (int i = 0; i < quiet_moves.count; i++) {
+    picker->moves[picker->count++] = quiet_moves.moves[i];
+  }
+}
+
+static void picker_reset(MovePicker *picker, const Board *board, int ply) {
+  picker->board = board;
+  picker->ply = ply;
+  picker->tt_move = MOVE_NONE;
+  picker->killers[0] = MOVE_NONE;
+  picker->killers[1] = MOVE_NONE;
+  picker->current = 0;
+  picker->bad_end = 0;
+  picker->bad_current = 0;
+  picker->capture_end = 0;
+  picker->count = 0;
+}
+
+void movepicker_init(MovePicker *picker, const Board *board, Move tt_move,
+                     int ply) {
+  picker_reset(picker, board, ply);
+  picker->qsearch = 0;
+
+#if VERSION >= 9
+  if (ply < 128) {
+    picker->killers[0] = ordering->killer_moves[ply][0];
+    picker->killers[1] = ordering->killer_moves[ply][1];
+  }
+#endif
+
+  // Le coup de la TT peut venir d'une autre position (collision) : il est
+  // vérifié avant d'être joué sans génération
+  picker->stage = STAGE_GENERATE;
+  if (tt_move != MOVE_NONE && is_move_pseudo_legal(board, &tt_move) &&
+      is_move_legal(board, &tt_move)) {
+    picker->tt_move = tt_move;
+    picker->stage = STAGE_TT_MOVE;
+  }
+}
+
+void movepicker_init_qsearch(MovePicker *picker, const Board *board) {
+  picker_reset(picker, board, 0);
+  picker->qsearch = 1;
+  picker->stage = STAGE_GENERATE;
+}
+
+// Killer jouable ici : coup calme différent du coup de la TT
+static int is_valid_killer(const MovePicker *picker, const Move *killer) {
+  return *killer != MOVE_NONE && *killer != picker->tt_move &&
+         !is_noisy_move(killer) && is_move_pseudo_legal(picker->board, killer) &&
+         is_move_legal(picker->board, killer);
+}
+
+int movepicker_next(MovePicker *picker, Move *move) {
+  while (1) {
+    switch (picker->stage) {
+    case STAGE_TT_MOVE:
+      picker->stage = STAGE_GENERATE;
+      *move = picker->tt_move;
+      return 1;
+
+    case STAGE_GENERATE:
+      picker->current = 0;
+#if VERSION >= 2
+      generate_picker_captures(picker);
+      picker->stage = STAGE_GOOD_CAPTURES;
+#else
+      // V1: tous les coups dans l'ordre de génération
+      if (picker->qsearch) {
+        generate_picker_captures(picker);
+        picker->capture_end = 0;
+      } else {
+        MoveList legal_moves;
+        generate_legal_moves(picker->board, &legal_moves);
+        for (int i = 0; i < legal_moves.count; i++)
+          picker->moves[i] = legal_moves.moves[i];
+        picker->count = legal_moves.count;
+      }
+      picker->stage = STAGE_QUIETS;
+#endif
+      break;
+
+    case STAGE_GOOD_CAPTURES:
+      while (picker->current < picker->capture_end) {
+        select_best(picker, picker->current, picker->capture_end);
+        Move candidate = picker->moves[picker->current++];
+        if (candidate == picker->tt_move)
+          continue;
+        // Les captures perdantes sont gardées pour la fin
+        if (see_capture(picker->board, &candidate) < 0) {
+          picker->moves[picker->bad_end++] = candidate;
+          continue;
+        }
+        *move = candidate;
+        return 1;
+      }
+      picker->stage = picker->qsearch ? STAGE_BAD_CAPTURES : STAGE_KILLER_1;
+      break;
+
+    case STAGE_KILLER_1:
+    case STAGE_KILLER_2: {
+      Move killer = picker->killers[picker->stage - STAGE_KILLER_1];
+      picker->stage++;
+      if (is_valid_killer(picker, &killer)) {
+        *move = killer;
+        return 1;
+      }
+      break;
+    }
+
+    case STAGE_SCORE_QUIETS:
+      generate_picker_quiets(picker);
+      for (int i = picker->capture_end; i < picker->count; i++) {
+#if VERSION >= 8
+        Move quiet = picker->moves[i];
+        picker->scores[i] =
+            ordering->history_scores[picker->board->to_move][MOVE_FROM(quiet)]
+                                    [MOVE_TO(quiet)];
+#else
+        picker->scores[i] = 0;
+#endif
+      }
+      picker->current = picker->capture_end;
+      picker->stage = STAGE_QUIETS;
+      break;
+
+    case STAGE_QUIETS:
+      while (picker->current < picker->count) {
+        select_best(picker, picker->current, picker->count);
+        Move candidate = picker->moves[picker->current++];
+        if (candidate == picker->tt_move || candidate == picker->killers[0] ||
+            candidate == picker->killers[1])
+          continue;
+        *move = candidate;
+        return 1;
+      }
+      picker->stage = STAGE_BAD_CAPTURES;
+      break;
+
+    case STAGE_BAD_CAPTURES:
+      if (picker->bad_current < picker->bad_end) {
+        *move = picker->moves[picker->bad_current++];
+        return 1;
+      }
+      picker->stage = STAGE_DONE;
+      break;
+
+    case STAGE_DONE:
+    default:
+      return 0;
+    }
+  }
+}
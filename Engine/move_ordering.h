@@ -11,14 +11,69 @@ typedef struct {
   int count;
 } OrderedMoveList;
 
+// Étapes du sélecteur de coups (chaque étape ne fait que le travail
+// nécessaire : une coupure sur le coup de la TT évite toute génération)
+typedef enum {
+  STAGE_TT_MOVE,
+  STAGE_GENERATE,
+  STAGE_GOOD_CAPTURES,
+  STAGE_KILLER_1,
+  STAGE_KILLER_2,
+  STAGE_SCORE_QUIETS,
+  STAGE_QUIETS,
+  STAGE_BAD_CAPTURES,
+  STAGE_DONE
+} PickerStage;
+
+// Sélecteur de coups par étapes : coup de la TT, bonnes captures
+// (MVV-LVA, SEE >= 0), killers, coups calmes (history), mauvaises captures
+typedef struct {
+  const Board *board;
+  PickerStage stage;
+  int qsearch; // Captures et promotions uniquement
+  int ply;
+  Move tt_move;
+  Move killers[2];
+
+  // Captures dans [0, capture_end), coups calmes dans [capture_end, count).
+  // Les mauvaises captures déjà vues sont recopiées en tête dans [0, bad_end)
+  Move moves[256];
+  int scores[256];
+  int current;
+  int bad_end;
+  int bad_current;
+  int capture_end;
+  int count;
+} MovePicker;
+
 // ========== FONCTIONS PRINCIPALES ==========
 
 // Ordonne les coups pour optimiser l'alpha-beta
 void order_moves(const Board *board, MoveList *moves, OrderedMoveList *ordered,
                  Move hash_move, int ply);
 
-// Initialise les tables de killer moves et history
-void init_killer_moves(void);
+// Prépare le sélecteur pour la recherche principale (tt_move : coup de la
+// table de transposition, MOVE_NONE si aucun)
+void movepicker_init(MovePicker *picker, const Board *board, Move tt_move,
+                     int ply);
+
+// Prépare le sélecteur pour la quiescence (captures et promotions)
+void movepicker_init_qsearch(MovePicker *picker, const Board *board);
+
+// Donne le prochain coup légal (1) ou 0 quand tous ont été proposés
+int movepicker_next(MovePicker *picker, Move *move);
+
+// Killer moves et history d'un thread de recherche
+typedef struct {
+  Move killer_moves[128][2];     // [ply][killer_slot]
+  int history_scores[2][64][64]; // [color][from][to]
+} OrderingTables;
+
+// Vide les tables de killer moves et history (nouvelle partie)
+void init_killer_moves(OrderingTables *tables);
+
+// Tables utilisées par le thread appelant (au début de chaque recherche)
+void set_ordering_tables(OrderingTables *tables);
 
 // ========== KILLER MOVES ==========
 
@@ -36,6 +91,11 @@ void update_history(Move move, int depth, Couleur color);
 // ========== MVV-LVA ==========
 
 // Score MVV-LVA (Most Valuable Victim - Least Valuable Attacker)
-int mvv_lva_score(const Move *move);
+int mvv_lva_score(const Board *board, const Move *move);
+
+// ========== SEE (Static Exchange Evaluation) ==========
+
+// Gain matériel de la séquence de captures sur la case d'arrivée
+int see_capture(const Board *board, const Move *move);
 
 #endif // MOVE_ORDERING_H
@@ -1,4 +1,7 @@
 #include "movegen.h"
+#include "attacks.h"
+#include "zobrist.h"
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,23 +19,30 @@ void movelist_add(MoveList *list, Move move) {
 }
 
 Move create_move(Square from, Square to, MoveType type) {
-  Move move;
-  move.from = from;
-  move.to = to;
-  move.type = type;
-  move.promotion = EMPTY;
-  move.captured_piece = EMPTY;
-  return move;
+  static const uint16_t type_flags[] = {
+      [MOVE_NORMAL] = 0,
+      [MOVE_CAPTURE] = MOVE_FLAG_CAPTURE,
+      [MOVE_EN_PASSANT] = MOVE_FLAGS_EN_PASSANT,
+      [MOVE_CASTLE] = MOVE_FLAGS_CASTLE,
+      [MOVE_PROMOTION] = MOVE_FLAG_PROMOTION | (QUEEN - KNIGHT),
+  };
+  return (Move)(from | (to << 6) | (type_flags[type] << 12));
+}
+
+Move create_promotion_move(Square from, Square to, PieceType promotion,
+                           int is_capture) {
+  uint16_t flags = MOVE_FLAG_PROMOTION | (promotion - KNIGHT);
+  if (is_capture)
+    flags |= MOVE_FLAG_CAPTURE;
+  return (Move)(from | (to << 6) | (flags << 12));
 }
 
-Move create_promotion_move(Square from, Square to, PieceType promotion) {
-  Move move;
-  move.from = from;
-  move.to = to;
-  move.type = MOVE_PROMOTION;
-  move.promotion = promotion;
-  move.captured_piece = EMPTY;
-  return move;
+PieceType move_captured_piece(const Board *board, Move move) {
+  if (!MOVE_IS_CAPTURE(move))
+    return EMPTY;
+  if (MOVE_TYPE(move) == MOVE_EN_PASSANT)
+    return PAWN;
+  return get_piece_type(board, MOVE_TO(move));
 }
 
 // Fonctions d'affichage déplacées vers utils.c
@@ -104,7 +114,7 @@ static void generate_pawn_pushes(const Board *board, Couleur color, Square from,
       !is_square_occupied(board, one_forward)) {
     int rank = one_forward / 8;
     if ((color == WHITE && rank == 7) || (color == BLACK && rank == 0)) {
-      ADD_PROMOTIONS(from, one_forward, EMPTY, moves);
+      ADD_PROMOTIONS(from, one_forward, 0, moves);
     } else {
       Move m = create_move(from, one_forward, MOVE_NORMAL);
       movelist_add(moves, m);
@@ -128,17 +138,13 @@ static void add_pawn_capture(const Board *board, Square from, Square to,
     return;
   if (get_piece_color(board, to) == color)
     return;
-
-  PieceType captured = get_piece_type(board, to);
   int rank = to / 8;
 
   // Promotion si dernière rangée
   if ((color == WHITE && rank == 7) || (color == BLACK && rank == 0)) {
-    ADD_PROMOTIONS(from, to, captured, moves);
+    ADD_PROMOTIONS(from, to, 1, moves);
   } else {
-    Move capture = create_move(from, to, MOVE_CAPTURE);
-    capture.captured_piece = captured;
-    movelist_add(moves, capture);
+    movelist_add(moves, create_move(from, to, MOVE_CAPTURE));
   }
 }
 
@@ -159,7 +165,7 @@ static void generate_pawn_captures(const Board *board, Couleur color,
 
 static void generate_en_passant(const Board *board, Couleur color,
                                 MoveList *moves) {
-  if (board->en_passant == -1)
+  if (board->en_passant == NO_SQUARE)
     return;
 
   int ep_rank_check = board->en_passant / 8;
@@ -187,7 +193,6 @@ static void generate_en_passant(const Board *board, Couleur color,
         get_piece_color(board, left_attacker) == color &&
         get_piece_type(board, left_attacker) == PAWN) {
       Move ep_move = create_move(left_attacker, ep_square, MOVE_EN_PASSANT);
-      ep_move.captured_piece = PAWN;
 #ifdef DEBUG
       fprintf(stderr, "[DEBUG EP] Adding left en-passant move from %d to %d\n",
               left_attacker, ep_square);
@@ -201,7 +206,6 @@ static void generate_en_passant(const Board *board, Couleur color,
         get_piece_color(board, right_attacker) == color &&
         get_piece_type(board, right_attacker) == PAWN) {
       Move ep_move = create_move(right_attacker, ep_square, MOVE_EN_PASSANT);
-      ep_move.captured_piece = PAWN;
 #ifdef DEBUG
       fprintf(stderr, "[DEBUG EP] Adding right en-passant move from %d to %d\n",
               right_attacker, ep_square);
@@ -238,82 +242,25 @@ void generate_pawn_moves(const Board *board, Couleur color, MoveList *moves) {
   generate_en_passant(board, color, moves);
 }
 
-// Calcule la distance minimale entre deux limites
-static inline int min(int a, int b) { return (a < b) ? a : b; }
-
-// Calcule le nombre maximum de pas pour une direction donnée
-static int calculate_max_steps(int rank, int file, int offset) {
-  switch (offset) {
-  case +8:
-    return 7 - rank; // Nord
-  case -8:
-    return rank; // Sud
-  case +1:
-    return 7 - file; // Est
-  case -1:
-    return file; // Ouest
-  case +9:
-    return min(7 - rank, 7 - file); // Nord-Est
-  case +7:
-    return min(7 - rank, file); // Nord-Ouest
-  case -7:
-    return min(rank, 7 - file); // Sud-Est
-  case -9:
-    return min(rank, file); // Sud-Ouest
-  default:
-    return 0; // Direction invalide
-  }
-}
+// Ajoute un coup par case cible : capture si la case est occupée (les cases
+// amies ont déjà été retirées des cibles), coup normal sinon
+static void add_target_moves(const Board *board, Square from, Bitboard targets,
+                             MoveList *moves) {
+  while (targets) {
+    Square to = __builtin_ctzll(targets);
+    targets &= targets - 1;
 
-// Tente d'ajouter un mouvement de capture
-static bool try_add_capture(const Board *board, Square from, Square to,
-                            Couleur color, MoveList *moves) {
-  if (get_piece_color(board, to) != color) {
-    Move capture = create_move(from, to, MOVE_CAPTURE);
-    capture.captured_piece = get_piece_type(board, to);
-    movelist_add(moves, capture);
-    return true;
-  }
-  return false;
-}
-
-// Ajoute un mouvement normal (case vide)
-static void add_normal_move(Square from, Square to, MoveList *moves) {
-  Move m = create_move(from, to, MOVE_NORMAL);
-  movelist_add(moves, m);
-}
-
-// Fonction principale simplifiée
-void slide_direction(const Board *board, Square from, int offset, Couleur color,
-                     MoveList *moves) {
-  int rank = from / 8;
-  int file = from % 8;
-  int max_steps = calculate_max_steps(rank, file, offset);
-
-  if (max_steps == 0)
-    return; // Direction invalide
-
-  for (int step = 1; step <= max_steps; step++) {
-    Square to = from + step * offset;
-
-    // Vérification de sécurité (redondante avec calculate_max_steps mais
-    // garde-fou)
-    if (to < A1 || to > H8)
-      break;
-
-    if (is_square_occupied(board, to)) {
-      try_add_capture(board, from, to, color, moves);
-      break; // Obstacle rencontré
+    if (GET_BIT(board->all_pieces, to)) {
+      movelist_add(moves, create_move(from, to, MOVE_CAPTURE));
+    } else {
+      movelist_add(moves, create_move(from, to, MOVE_NORMAL));
     }
-
-    add_normal_move(from, to, moves);
   }
 }
 
 // Génération des mouvements de tour
 void generate_rook_moves(const Board *board, Couleur color, MoveList *moves) {
   // Vérifications de sécurité
-
   if (!moves || !board)
     return;
 
@@ -325,16 +272,10 @@ void generate_rook_moves(const Board *board, Couleur color, MoveList *moves) {
     Square from = __builtin_ctzll(rooks); // Trouve la première tour
     rooks &= (rooks - 1);                 // Efface ce bit
 
-    // Vérifier la validité de la case
-    if (from < A1 || from > H8) {
-      continue;
-    }
-
-    // Générer les mouvements dans les 4 directions orthogonales
-    slide_direction(board, from, +8, color, moves); // Nord
-    slide_direction(board, from, -8, color, moves); // Sud
-    slide_direction(board, from, +1, color, moves); // Est
-    slide_direction(board, from, -1, color, moves); // Ouest
+    // Cibles des 4 directions orthogonales en une seule lecture de table
+    Bitboard targets =
+        rook_attacks(from, board->all_pieces) & ~board->occupied[color];
+    add_target_moves(board, from, targets, moves);
   }
 }
 
@@ -353,16 +294,10 @@ void generate_bishop_moves(const Board *board, Couleur color, MoveList *moves) {
     Square from = __builtin_ctzll(bishops); // Trouve le premier fou
     bishops &= (bishops - 1);               // Efface ce bit
 
-    // Vérifier la validité de la case
-    if (from < A1 || from > H8) {
-      continue;
-    }
-
-    // Générer les mouvements dans les 4 directions diagonales
-    slide_direction(board, from, +9, color, moves); // Nord-Est
-    slide_direction(board, from, +7, color, moves); // Nord-Ouest
-    slide_direction(board, from, -7, color, moves); // Sud-Est
-    slide_direction(board, from, -9, color, moves); // Sud-Ouest
+    // Cibles des 4 directions diagonales en une seule lecture de table
+    Bitboard targets =
+        bishop_attacks(from, board->all_pieces) & ~board->occupied[color];
+    add_target_moves(board, from, targets, moves);
   }
 }
 
@@ -373,18 +308,12 @@ void generate_knight_moves(const Board *board, Couleur color, MoveList *moves) {
   if (!moves || !board)
     return;
 
-  // Offsets des 8 mouvements possibles du cavalier (en forme de L)
-  static const int knight_offsets[8] = {
-      +17, +15, +10, +6, // Mouvements vers le haut
-      -6,  -10, -15, -17 // Mouvements vers le bas
-  };
-
   // Récupérer le bitboard des cavaliers de cette couleur
   Bitboard knights = board->pieces[color][KNIGHT];
 
 #ifdef DEBUG
   fprintf(stderr, "[DEBUG KNIGHT] Generating for %s, bitboard=0x%llx\n",
-          color == WHITE ? "WHITE" : "BLACK", knights);
+          color == WHITE ? "WHITE" : "BLACK", (unsigned long long)knights);
 #endif
 
   // Parcourir tous les cavaliers avec la méthode bitboard
@@ -392,49 +321,9 @@ void generate_knight_moves(const Board *board, Couleur color, MoveList *moves) {
     Square from = __builtin_ctzll(knights); // Trouve le premier cavalier
     knights &= (knights - 1);               // Efface ce bit
 
-    // Vérifier la validité de la case
-    if (from < A1 || from > H8) {
-      continue;
-    }
-
-    int from_file = from % 8;
-    int from_rank = from / 8;
-
-    // Tester les 8 mouvements possibles
-    for (int i = 0; i < 8; i++) {
-      Square to = from + knight_offsets[i];
-
-      // Vérification basique : case dans les limites du plateau
-      if (to < A1 || to > H8) {
-        continue;
-      }
-
-      int to_file = to % 8;
-      int to_rank = to / 8;
-
-      // Vérification smart anti-wrap : déplacement colonne/rangée cohérent
-      int file_diff = abs(to_file - from_file);
-      int rank_diff = abs(to_rank - from_rank);
-
-      // Cavalier : soit (1,2) soit (2,1) en déplacement colonne/rangée
-      if (!((file_diff == 1 && rank_diff == 2) ||
-            (file_diff == 2 && rank_diff == 1))) {
-        continue; // Mouvement invalide (wrap-around détecté)
-      }
-
-      // Case vide → mouvement normal
-      if (!is_square_occupied(board, to)) {
-        Move m = create_move(from, to, MOVE_NORMAL);
-        movelist_add(moves, m);
-      }
-      // Case occupée par pièce ennemie → capture
-      else if (get_piece_color(board, to) != color) {
-        Move capture = create_move(from, to, MOVE_CAPTURE);
-        capture.captured_piece = get_piece_type(board, to);
-        movelist_add(moves, capture);
-      }
-      // Case occupée par pièce amie → ignorer
-    }
+    // Les 8 sauts sont précalculés (pas de débordement de colonne possible)
+    Bitboard targets = knight_attacks(from) & ~board->occupied[color];
+    add_target_moves(board, from, targets, moves);
   }
 }
 
@@ -453,23 +342,10 @@ void generate_queen_moves(const Board *board, Couleur color, MoveList *moves) {
     Square from = __builtin_ctzll(queens); // Trouve la première dame
     queens &= (queens - 1);                // Efface ce bit
 
-    // Vérifier la validité de la case
-    if (from < A1 || from > H8) {
-      continue;
-    }
-
-    // Générer les mouvements dans les 8 directions (tour + fou)
-    // Directions orthogonales (tour)
-    slide_direction(board, from, +8, color, moves); // Nord
-    slide_direction(board, from, -8, color, moves); // Sud
-    slide_direction(board, from, +1, color, moves); // Est
-    slide_direction(board, from, -1, color, moves); // Ouest
-
-    // Directions diagonales (fou)
-    slide_direction(board, from, +9, color, moves); // Nord-Est
-    slide_direction(board, from, +7, color, moves); // Nord-Ouest
-    slide_direction(board, from, -7, color, moves); // Sud-Est
-    slide_direction(board, from, -9, color, moves); // Sud-Ouest
+    // Cibles des 8 directions (tour + fou)
+    Bitboard targets =
+        queen_attacks(from, board->all_pieces) & ~board->occupied[color];
+    add_target_moves(board, from, targets, moves);
   }
 }
 
@@ -479,8 +355,8 @@ int is_castle_illegal(const Board *board, const Move *m) {
   if (!board || !m)
     return 0;
   // On ne s'intéresse qu'aux déplacements du roi de 2 cases latérales
-  int from = m->from;
-  int to = m->to;
+  int from = MOVE_FROM(*m);
+  int to = MOVE_TO(*m);
   Couleur color = get_piece_color(board, from);
   int from_rank = from / 8;
   int from_file = from % 8;
@@ -642,18 +518,6 @@ void generate_king_moves(const Board *board, Couleur color, MoveList *moves) {
   if (!moves || !board)
     return;
 
-  // Offsets des 8 mouvements possibles du roi (1 case dans chaque direction)
-  static const int king_offsets[8] = {
-      +8, // Nord
-      -8, // Sud
-      +1, // Est
-      -1, // Ouest
-      +9, // Nord-Est
-      +7, // Nord-Ouest
-      -7, // Sud-Est
-      -9  // Sud-Ouest
-  };
-
   // Récupérer le bitboard du roi de cette couleur
   Bitboard kings = board->pieces[color][KING];
 
@@ -662,40 +526,9 @@ void generate_king_moves(const Board *board, Couleur color, MoveList *moves) {
     Square from = __builtin_ctzll(kings); // Trouve le roi
     kings &= (kings - 1);                 // Efface ce bit
 
-    // Vérifier la validité de la case
-    if (from < A1 || from > H8) {
-      continue;
-    }
-
-    int from_file = from % 8;
-    int from_rank = from / 8;
-
-    // Tester les 8 mouvements possibles
-    for (int i = 0; i < 8; i++) {
-      Square to = from + king_offsets[i];
-      // Vérification basique : case dans les limites du plateau
-      if (to < A1 || to > H8) {
-        continue;
-      }
-      int to_file = to % 8;
-      int to_rank = to / 8;
-      // Vérification anti-wrap : déplacement max 1 case en colonne/rangée
-      int file_diff = abs(to_file - from_file);
-      int rank_diff = abs(to_rank - from_rank);
-      if (file_diff > 1 || rank_diff > 1) {
-        continue; // Mouvement invalide (wrap-around détecté)
-      }
-      // Coups pseudo-légaux du roi
-      if (!is_square_occupied(board, to)) {
-        Move m = create_move(from, to, MOVE_NORMAL);
-        movelist_add(moves, m);
-      } else if (get_piece_color(board, to) != color) {
-        Move m = create_move(from, to, MOVE_CAPTURE);
-        m.captured_piece = get_piece_type(board, to);
-        movelist_add(moves, m);
-      }
-      // Case occupée par pièce amie → ignorer
-    }
+    // Coups pseudo-légaux du roi (cases amies exclues)
+    Bitboard targets = king_attacks(from) & ~board->occupied[color];
+    add_target_moves(board, from, targets, moves);
   }
 
   // Ajouter les roques si conditions remplies
@@ -707,6 +540,28 @@ void generate_king_moves(const Board *board, Couleur color, MoveList *moves) {
   }
 }
 
+// Ensemble des pièces (des deux couleurs) qui attaquent une case, pour une
+// occupation donnée : permet de "retirer" des pièces (rayons X, SEE)
+Bitboard attackers_to(const Board *board, Square square, Bitboard occupancy) {
+  Bitboard rooks_queens =
+      board->pieces[WHITE][ROOK] | board->pieces[BLACK][ROOK] |
+      board->pieces[WHITE][QUEEN] | board->pieces[BLACK][QUEEN];
+  Bitboard bishops_queens =
+      board->pieces[WHITE][BISHOP] | board->pieces[BLACK][BISHOP] |
+      board->pieces[WHITE][QUEEN] | board->pieces[BLACK][QUEEN];
+
+  // Symétrie des attaques : un pion blanc attaque la case si un pion noir
+  // placé sur cette case l'attaquerait
+  return (pawn_attacks(BLACK, square) & board->pieces[WHITE][PAWN]) |
+         (pawn_attacks(WHITE, square) & board->pieces[BLACK][PAWN]) |
+         (knight_attacks(square) &
+          (board->pieces[WHITE][KNIGHT] | board->pieces[BLACK][KNIGHT])) |
+         (king_attacks(square) &
+          (board->pieces[WHITE][KING] | board->pieces[BLACK][KING])) |
+         (bishop_attacks(square, occupancy) & bishops_queens) |
+         (rook_attacks(square, occupancy) & rooks_queens);
+}
+
 // Vérifie si une case est attaquée par la couleur adverse
 int is_square_attacked(const Board *board, Square square,
                        Couleur attacking_color) {
@@ -714,117 +569,23 @@ int is_square_attacked(const Board *board, Square square,
     return 0;
   }
 
-  int target_rank = square / 8;
-  int target_file = square % 8;
-
-  // Vérifier attaques de pions
-  int pawn_direction = (attacking_color == WHITE) ? 1 : -1;
-  int pawn_rank = target_rank - pawn_direction;
-
-  if (pawn_rank >= 0 && pawn_rank <= 7) {
-    // Pion attaque depuis la gauche
-    if (target_file > 0) {
-      Square left_pawn = pawn_rank * 8 + (target_file - 1);
-      if (is_square_occupied(board, left_pawn) &&
-          get_piece_color(board, left_pawn) == attacking_color &&
-          get_piece_type(board, left_pawn) == PAWN) {
-        return 1;
-      }
-    }
-    // Pion attaque depuis la droite
-    if (target_file < 7) {
-      Square right_pawn = pawn_rank * 8 + (target_file + 1);
-      if (is_square_occupied(board, right_pawn) &&
-          get_piece_color(board, right_pawn) == attacking_color &&
-          get_piece_type(board, right_pawn) == PAWN) {
-        return 1;
-      }
-    }
-  }
-
-  // Vérifier attaques de cavalier
-  static const int knight_moves[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-                                         {1, -2},  {1, 2},  {2, -1},  {2, 1}};
-
-  for (int i = 0; i < 8; i++) {
-    int rank = target_rank + knight_moves[i][0];
-    int file = target_file + knight_moves[i][1];
-
-    if (rank >= 0 && rank <= 7 && file >= 0 && file <= 7) {
-      Square from = rank * 8 + file;
-      if (is_square_occupied(board, from) &&
-          get_piece_color(board, from) == attacking_color &&
-          get_piece_type(board, from) == KNIGHT) {
-        return 1;
-      }
-    }
-  }
-
-  // Vérifier attaques orthogonales (tour/dame)
-  static const int rook_dirs[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-  for (int dir = 0; dir < 4; dir++) {
-    for (int dist = 1; dist < 8; dist++) {
-      int rank = target_rank + dist * rook_dirs[dir][0];
-      int file = target_file + dist * rook_dirs[dir][1];
-
-      if (rank < 0 || rank > 7 || file < 0 || file > 7)
-        break;
-
-      Square from = rank * 8 + file;
-      if (is_square_occupied(board, from)) {
-        if (get_piece_color(board, from) == attacking_color) {
-          PieceType piece = get_piece_type(board, from);
-          if (piece == ROOK || piece == QUEEN) {
-            return 1;
-          }
-        }
-        break; // Pièce bloque
-      }
-    }
-  }
-
-  // Vérifier attaques diagonales (fou/dame)
-  static const int bishop_dirs[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
-  for (int dir = 0; dir < 4; dir++) {
-    for (int dist = 1; dist < 8; dist++) {
-      int rank = target_rank + dist * bishop_dirs[dir][0];
-      int file = target_file + dist * bishop_dirs[dir][1];
-
-      if (rank < 0 || rank > 7 || file < 0 || file > 7)
-        break;
-
-      Square from = rank * 8 + file;
-      if (is_square_occupied(board, from)) {
-        if (get_piece_color(board, from) == attacking_color) {
-          PieceType piece = get_piece_type(board, from);
-          if (piece == BISHOP || piece == QUEEN) {
-            return 1;
-          }
-        }
-        break; // Pièce bloque
-      }
-    }
-  }
-
-  // Vérifier attaques de roi
-  for (int rank_offset = -1; rank_offset <= 1; rank_offset++) {
-    for (int file_offset = -1; file_offset <= 1; file_offset++) {
-      if (rank_offset == 0 && file_offset == 0)
-        continue;
+  const Bitboard *pieces = board->pieces[attacking_color];
+  Couleur defending_color = (attacking_color == WHITE) ? BLACK : WHITE;
 
-      int rank = target_rank + rank_offset;
-      int file = target_file + file_offset;
+  // Pièces sautantes d'abord (tests les moins coûteux)
+  if (pawn_attacks(defending_color, square) & pieces[PAWN])
+    return 1;
+  if (knight_attacks(square) & pieces[KNIGHT])
+    return 1;
+  if (king_attacks(square) & pieces[KING])
+    return 1;
 
-      if (rank >= 0 && rank <= 7 && file >= 0 && file <= 7) {
-        Square from = rank * 8 + file;
-        if (is_square_occupied(board, from) &&
-            get_piece_color(board, from) == attacking_color &&
-            get_piece_type(board, from) == KING) {
-          return 1;
-        }
-      }
-    }
-  }
+  // Pièces glissantes : une lecture de table par type de rayon
+  if (bishop_attacks(square, board->all_pieces) &
+      (pieces[BISHOP] | pieces[QUEEN]))
+    return 1;
+  if (rook_attacks(square, board->all_pieces) & (pieces[ROOK] | pieces[QUEEN]))
+    return 1;
 
   return 0;
 }
@@ -846,18 +607,29 @@ int is_in_check(const Board *board, Couleur color) {
   return is_square_attacked(board, king_square, opponent);
 }
 
-// Effectue temporairement un mouvement pour tester sa légalité
-void make_move_temp(Board *board, const Move *move, Board *backup) {
-
-  // Sauvegarder l'état actuel
-  *backup = *board;
+// Joue un coup sur place. undo reçoit uniquement ce que le coup détruit
+// (pièce capturée, roques, en passant, compteur, clé) pour unmake_move
+void make_move(Board *board, const Move *move, UndoInfo *undo) {
+  undo->captured_piece = EMPTY;
+  undo->castle_rights = board->castle_rights;
+  undo->en_passant = board->en_passant;
+  undo->halfmove_clock = board->halfmove_clock;
+  undo->zobrist_key = board->zobrist_key;
+
+  // Clé Zobrist : retirer l'ancien état (roques, en passant), les nouveaux
+  // sont ajoutés en fin de coup
+  uint64_t key = board->zobrist_key ^ zobrist_castling[board->castle_rights];
+  if (board->en_passant != NO_SQUARE)
+    key ^= zobrist_en_passant[board->en_passant];
 
   // Effacer la pièce de la case de départ
-  PieceType piece_type = get_piece_type(board, move->from);
-  Couleur piece_color = get_piece_color(board, move->from);
+  PieceType piece_type = get_piece_type(board, MOVE_FROM(*move));
+  Couleur piece_color = get_piece_color(board, MOVE_FROM(*move));
 
-  board->pieces[piece_color][piece_type] &= ~(1ULL << move->from);
-  board->occupied[piece_color] &= ~(1ULL << move->from);
+  board->pieces[piece_color][piece_type] &= ~(1ULL << MOVE_FROM(*move));
+  board->occupied[piece_color] &= ~(1ULL << MOVE_FROM(*move));
+  board->piece_on[MOVE_FROM(*move)] = NO_PIECE;
+  key ^= zobrist_pieces[piece_color][piece_type][MOVE_FROM(*move)];
 
   // Mettre à jour les droits de roque
   if (piece_type == KING) {
@@ -868,35 +640,37 @@ void make_move_temp(Board *board, const Move *move, Board *backup) {
     }
   } else if (piece_type == ROOK) {
     if (piece_color == WHITE) {
-      if (move->from == H1)
+      if (MOVE_FROM(*move) == H1)
         board->castle_rights &= ~WHITE_KINGSIDE;
-      if (move->from == A1)
+      if (MOVE_FROM(*move) == A1)
         board->castle_rights &= ~WHITE_QUEENSIDE;
     } else {
-      if (move->from == H8)
+      if (MOVE_FROM(*move) == H8)
         board->castle_rights &= ~BLACK_KINGSIDE;
-      if (move->from == A8)
+      if (MOVE_FROM(*move) == A8)
         board->castle_rights &= ~BLACK_QUEENSIDE;
     }
   }
 
   // Gérer la capture (y compris les promotions avec capture)
   PieceType captured_piece_type = EMPTY;
-  Square captured_square = move->to;
-  if (move->type == MOVE_CAPTURE || move->type == MOVE_EN_PASSANT ||
-      (move->type == MOVE_PROMOTION && move->captured_piece != EMPTY)) {
+  Square captured_square = MOVE_TO(*move);
+  if (MOVE_IS_CAPTURE(*move)) {
     Couleur opponent = (piece_color == WHITE) ? BLACK : WHITE;
-    if (move->type == MOVE_EN_PASSANT) {
-      captured_square = (piece_color == WHITE) ? move->to - 8 : move->to + 8;
+    if (MOVE_TYPE(*move) == MOVE_EN_PASSANT) {
+      captured_square = (piece_color == WHITE) ? MOVE_TO(*move) - 8 : MOVE_TO(*move) + 8;
       captured_piece_type = PAWN;
     } else {
-      captured_piece_type = move->captured_piece;
+      captured_piece_type = get_piece_type(board, MOVE_TO(*move));
     }
 
+    undo->captured_piece = captured_piece_type;
     if (captured_piece_type != EMPTY) {
       board->pieces[opponent][captured_piece_type] &=
           ~(1ULL << captured_square);
       board->occupied[opponent] &= ~(1ULL << captured_square);
+      board->piece_on[captured_square] = NO_PIECE;
+      key ^= zobrist_pieces[opponent][captured_piece_type][captured_square];
 
       // Si une tour est capturée sur sa case initiale, annuler le droit de
       // roque IMPORTANT: Ce bloc doit être à l'intérieur du if
@@ -915,17 +689,17 @@ void make_move_temp(Board *board, const Move *move, Board *backup) {
   }
 
   // Placer la pièce sur la case d'arrivée
-  if (move->type == MOVE_PROMOTION) {
-    board->pieces[piece_color][move->promotion] |= (1ULL << move->to);
-  } else {
-    board->pieces[piece_color][piece_type] |= (1ULL << move->to);
-  }
-  board->occupied[piece_color] |= (1ULL << move->to);
+  PieceType placed_type =
+      (MOVE_TYPE(*move) == MOVE_PROMOTION) ? MOVE_PROMOTION_PIECE(*move) : piece_type;
+  board->pieces[piece_color][placed_type] |= (1ULL << MOVE_TO(*move));
+  key ^= zobrist_pieces[piece_color][placed_type][MOVE_TO(*move)];
+  board->occupied[piece_color] |= (1ULL << MOVE_TO(*move));
+  board->piece_on[MOVE_TO(*move)] = MAKE_PIECE(piece_color, placed_type);
 
   // Gérer le roque
-  if (move->type == MOVE_CASTLE) {
+  if (MOVE_TYPE(*move) == MOVE_CASTLE) {
     Square rook_from, rook_to;
-    if (move->to > move->from) { // Petit roque
+    if (MOVE_TO(*move) > MOVE_FROM(*move)) { // Petit roque
       rook_from = (piece_color == WHITE) ? H1 : H8;
       rook_to = (piece_color == WHITE) ? F1 : F8;
     } else { // Grand roque
@@ -938,35 +712,142 @@ void make_move_temp(Board *board, const Move *move, Board *backup) {
     board->pieces[piece_color][ROOK] |= (1ULL << rook_to);
     board->occupied[piece_color] &= ~(1ULL << rook_from);
     board->occupied[piece_color] |= (1ULL << rook_to);
+    board->piece_on[rook_from] = NO_PIECE;
+    board->piece_on[rook_to] = MAKE_PIECE(piece_color, ROOK);
+    key ^= zobrist_pieces[piece_color][ROOK][rook_from] ^
+           zobrist_pieces[piece_color][ROOK][rook_to];
   }
 
   // Recalculer all_pieces
   board->all_pieces = board->occupied[WHITE] | board->occupied[BLACK];
 
   // Réinitialiser en_passant par défaut
-  board->en_passant = -1;
+  board->en_passant = NO_SQUARE;
   // Si un pion avance de deux cases, définir la case en_passant
-  if (piece_type == PAWN && abs((int)move->to - (int)move->from) == 16) {
+  if (piece_type == PAWN && abs((int)MOVE_TO(*move) - (int)MOVE_FROM(*move)) == 16) {
     board->en_passant =
-        (piece_color == WHITE) ? (move->from + 8) : (move->from - 8);
+        (piece_color == WHITE) ? (MOVE_FROM(*move) + 8) : (MOVE_FROM(*move) - 8);
+  }
+  // Compteurs : règle des 50 coups et numéro de coup (après les noirs)
+  if (piece_type == PAWN || captured_piece_type != EMPTY) {
+    board->halfmove_clock = 0;
+  } else {
+    board->halfmove_clock++;
   }
+  if (piece_color == BLACK) {
+    board->move_number++;
+  }
+
   // Basculer le joueur actif
   board->to_move = (board->to_move == WHITE) ? BLACK : WHITE;
+
+  key ^= zobrist_castling[board->castle_rights] ^ zobrist_side_to_move;
+  if (board->en_passant != NO_SQUARE)
+    key ^= zobrist_en_passant[board->en_passant];
+  board->zobrist_key = key;
+
+#ifdef DEBUG
+  // Vérification croisée avec le recalcul complet
+  if (key != zobrist_hash(board)) {
+    fprintf(stderr, "[DEBUG ZOBRIST] Clé incrémentale incorrecte après %d->%d "
+                    "(type=%d)\n",
+            MOVE_FROM(*move), MOVE_TO(*move), MOVE_TYPE(*move));
+  }
+  // Mailbox et bitboards doivent rester d'accord
+  assert(board_mailbox_consistent(board));
+#endif
 }
 
-// Restaure l'état du board
-void unmake_move_temp(Board *board, const Board *backup) { *board = *backup; }
+// Annule make_move : les mêmes bits sont inversés, l'état irréversible
+// (roques, en passant, compteur, clé) vient de l'enregistrement undo
+void unmake_move(Board *board, const Move *move, const UndoInfo *undo) {
+  Bitboard from_bb = 1ULL << MOVE_FROM(*move);
+  Bitboard to_bb = 1ULL << MOVE_TO(*move);
+  Couleur color = get_piece_color(board, MOVE_TO(*move));
+  Couleur opponent = (color == WHITE) ? BLACK : WHITE;
+
+  // Ramener la pièce (un pion si c'était une promotion)
+  PieceType placed_type = get_piece_type(board, MOVE_TO(*move));
+  PieceType moved_type =
+      (MOVE_TYPE(*move) == MOVE_PROMOTION) ? PAWN : placed_type;
+  board->pieces[color][placed_type] &= ~to_bb;
+  board->pieces[color][moved_type] |= from_bb;
+  board->occupied[color] ^= from_bb | to_bb;
+  board->piece_on[MOVE_TO(*move)] = NO_PIECE;
+  board->piece_on[MOVE_FROM(*move)] = MAKE_PIECE(color, moved_type);
+
+  // Remettre la tour du roque
+  if (MOVE_TYPE(*move) == MOVE_CASTLE) {
+    Square rook_from, rook_to;
+    if (MOVE_TO(*move) > MOVE_FROM(*move)) { // Petit roque
+      rook_from = (color == WHITE) ? H1 : H8;
+      rook_to = (color == WHITE) ? F1 : F8;
+    } else { // Grand roque
+      rook_from = (color == WHITE) ? A1 : A8;
+      rook_to = (color == WHITE) ? D1 : D8;
+    }
+    Bitboard rook_squares = (1ULL << rook_from) | (1ULL << rook_to);
+    board->pieces[color][ROOK] ^= rook_squares;
+    board->occupied[color] ^= rook_squares;
+    board->piece_on[rook_to] = NO_PIECE;
+    board->piece_on[rook_from] = MAKE_PIECE(color, ROOK);
+  }
+
+  // Restaurer la pièce capturée
+  if (undo->captured_piece != EMPTY) {
+    Square captured_square = MOVE_TO(*move);
+    if (MOVE_TYPE(*move) == MOVE_EN_PASSANT)
+      captured_square = (color == WHITE) ? MOVE_TO(*move) - 8 : MOVE_TO(*move) + 8;
+    board->pieces[opponent][undo->captured_piece] |= 1ULL << captured_square;
+    board->occupied[opponent] |= 1ULL << captured_square;
+    board->piece_on[captured_square] = MAKE_PIECE(opponent, undo->captured_piece);
+  }
+
+  board->all_pieces = board->occupied[WHITE] | board->occupied[BLACK];
+
+  board->to_move = color;
+  board->castle_rights = undo->castle_rights;
+  board->en_passant = undo->en_passant;
+  board->halfmove_clock = undo->halfmove_clock;
+  board->zobrist_key = undo->zobrist_key;
+  if (color == BLACK) {
+    board->move_number--;
+  }
+
+#ifdef DEBUG
+  assert(board_mailbox_consistent(board));
+#endif
+}
+
+// Coup nul (null move pruning) : seuls le trait et l'en passant changent
+void make_null_move(Board *board, UndoInfo *undo) {
+  undo->captured_piece = EMPTY;
+  undo->castle_rights = board->castle_rights;
+  undo->en_passant = board->en_passant;
+  undo->halfmove_clock = board->halfmove_clock;
+  undo->zobrist_key = board->zobrist_key;
+
+  board->zobrist_key ^= zobrist_side_to_move;
+  if (board->en_passant != NO_SQUARE)
+    board->zobrist_key ^= zobrist_en_passant[board->en_passant];
+  board->en_passant = NO_SQUARE;
+  board->to_move = (board->to_move == WHITE) ? BLACK : WHITE;
+}
+
+void unmake_null_move(Board *board, const UndoInfo *undo) {
+  board->to_move = (board->to_move == WHITE) ? BLACK : WHITE;
+  board->en_passant = undo->en_passant;
+  board->zobrist_key = undo->zobrist_key;
+}
 
 // Vérifie si un mouvement est légal (ne met pas le roi en échec)
 int is_move_legal(const Board *board, const Move *move) {
 
   // 1. Vérifier que la case de départ contient bien une pièce du joueur actif
-  if (move->from < A1 || move->from > H8)
-    return 0;
-  if (!is_square_occupied(board, move->from)) {
+  if (!is_square_occupied(board, MOVE_FROM(*move))) {
     return 0;
   }
-  Couleur moving_color = get_piece_color(board, move->from);
+  Couleur moving_color = get_piece_color(board, MOVE_FROM(*move));
   if (moving_color != board->to_move) {
     return 0;
   }
@@ -974,24 +855,38 @@ int is_move_legal(const Board *board, const Move *move) {
   // 2. Vérifier que la destination est valide :
   // - soit vide
   // - soit occupée par une pièce adverse (jamais une pièce amie)
-  if (move->to < A1 || move->to > H8)
-    return 0;
-  if (is_square_occupied(board, move->to)) {
-    Couleur dest_color = get_piece_color(board, move->to);
+  if (is_square_occupied(board, MOVE_TO(*move))) {
+    Couleur dest_color = get_piece_color(board, MOVE_TO(*move));
     if (dest_color == moving_color) {
       return 0;
     }
   }
 
-  Board temp_board, backup;
-  temp_board = *board;
-
-  make_move_temp(&temp_board, move, &backup);
+  // 3. Roi attaqué après le coup ? Calculé sur les bitboards sans jouer le
+  // coup : occupation modifiée et pièce capturée retirée des attaquants
+  Bitboard kings = board->pieces[moving_color][KING];
+  if (kings == 0)
+    return 1; // Pas de roi (situation anormale) : jamais en échec
+
+  Bitboard from_bb = 1ULL << MOVE_FROM(*move);
+  Bitboard to_bb = 1ULL << MOVE_TO(*move);
+  Bitboard captured_bb = to_bb;
+  if (MOVE_TYPE(*move) == MOVE_EN_PASSANT) {
+    captured_bb = 1ULL << ((moving_color == WHITE) ? MOVE_TO(*move) - 8
+                                                   : MOVE_TO(*move) + 8);
+  }
+  Bitboard occupancy = (board->all_pieces & ~from_bb & ~captured_bb) | to_bb;
+  if (MOVE_TYPE(*move) == MOVE_CASTLE) {
+    // La tour arrive à côté du roi
+    Square rook_to = (MOVE_TO(*move) > MOVE_FROM(*move)) ? MOVE_TO(*move) - 1 : MOVE_TO(*move) + 1;
+    occupancy |= 1ULL << rook_to;
+  }
 
-  // Vérifier si le roi est en échec après le mouvement
-  int legal = !is_in_check(&temp_board, moving_color);
+  Square king_sq = (kings & from_bb) ? MOVE_TO(*move) : (Square)__builtin_ctzll(kings);
+  Couleur opponent = (moving_color == WHITE) ? BLACK : WHITE;
+  Bitboard enemies = board->occupied[opponent] & ~captured_bb;
 
-  return legal;
+  return !(attackers_to(board, king_sq, occupancy) & enemies);
 }
 
 // Filtre les mouvements illégaux d'une liste
@@ -1017,10 +912,379 @@ void filter_legal_moves(const Board *board, MoveList *moves) {
   *moves = legal_moves;
 }
 
-// Génération de mouvements légaux uniquement
+// ========== GÉNÉRATION LÉGALE (CLOUAGES ET MASQUE D'ÉCHEC) ==========
+
+// Sous-ensemble de coups à générer
+typedef enum { GEN_ALL, GEN_NOISY, GEN_QUIET } MoveGenKind;
+
+// Pièces de la couleur donnée clouées sur leur roi : une seule pièce (amie)
+// entre le roi et une pièce glissante adverse alignée
+static Bitboard pinned_pieces(const Board *board, Couleur color,
+                              Square king_sq) {
+  Couleur opponent = (color == WHITE) ? BLACK : WHITE;
+  const Bitboard *enemy = board->pieces[opponent];
+
+  // Pièces glissantes adverses alignées avec le roi (échiquier vide)
+  Bitboard snipers =
+      (rook_attacks(king_sq, 0) & (enemy[ROOK] | enemy[QUEEN])) |
+      (bishop_attacks(king_sq, 0) & (enemy[BISHOP] | enemy[QUEEN]));
+
+  Bitboard pinned = 0;
+  while (snipers) {
+    Square sniper = __builtin_ctzll(snipers);
+    snipers &= snipers - 1;
+
+    Bitboard blockers = between_squares(king_sq, sniper) & board->all_pieces;
+    if (blockers && !(blockers & (blockers - 1))) {
+      pinned |= blockers & board->occupied[color];
+    }
+  }
+  return pinned;
+}
+
+// Coups de pion légaux : "allowed" combine le masque d'échec et la ligne de
+// clouage. La prise en passant est validée par make/test car elle retire
+// deux pièces de la même rangée (échec à la découverte horizontal)
+static void generate_legal_pawn_moves(const Board *board, Couleur color,
+                                      Square king_sq, Bitboard check_mask,
+                                      Bitboard pinned, MoveGenKind kind,
+                                      MoveList *moves) {
+  int want_noisy = (kind != GEN_QUIET);
+  int want_quiet = (kind != GEN_NOISY);
+  int direction = (color == WHITE) ? 8 : -8;
+  Bitboard start_rank = (color == WHITE) ? 0x000000000000FF00ULL
+                                         : 0x00FF000000000000ULL;
+  Bitboard promotion_rank = (color == WHITE) ? 0xFF00000000000000ULL
+                                             : 0x00000000000000FFULL;
+  Bitboard enemies = board->occupied[(color == WHITE) ? BLACK : WHITE];
+  Bitboard pawns = board->pieces[color][PAWN];
+
+  while (pawns) {
+    Square from = __builtin_ctzll(pawns);
+    pawns &= pawns - 1;
+
+    Bitboard allowed = check_mask;
+    if (GET_BIT(pinned, from))
+      allowed &= line_through(king_sq, from);
+
+    // Poussées simples et doubles (une poussée promue est un coup tactique)
+    Square one_forward = from + direction;
+    if (!GET_BIT(board->all_pieces, one_forward)) {
+      if (GET_BIT(allowed, one_forward)) {
+        if (GET_BIT(promotion_rank, one_forward)) {
+          if (want_noisy)
+            ADD_PROMOTIONS(from, one_forward, 0, moves);
+        } else if (want_quiet) {
+          movelist_add(moves, create_move(from, one_forward, MOVE_NORMAL));
+        }
+      }
+
+      Square two_forward = one_forward + direction;
+      if (want_quiet && GET_BIT(start_rank, from) &&
+          !GET_BIT(board->all_pieces, two_forward) &&
+          GET_BIT(allowed, two_forward)) {
+        movelist_add(moves, create_move(from, two_forward, MOVE_NORMAL));
+      }
+    }
+
+    if (!want_noisy)
+      continue;
+
+    // Captures (avec promotion sur la dernière rangée)
+    Bitboard captures = pawn_attacks(color, from) & enemies & allowed;
+    while (captures) {
+      Square to = __builtin_ctzll(captures);
+      captures &= captures - 1;
+      if (GET_BIT(promotion_rank, to)) {
+        ADD_PROMOTIONS(from, to, 1, moves);
+      } else {
+        movelist_add(moves, create_move(from, to, MOVE_CAPTURE));
+      }
+    }
+  }
+
+  // En passant (rare) : vérification complète par is_move_legal
+  if (!want_noisy || board->en_passant == NO_SQUARE)
+    return;
+  int ep_rank = board->en_passant / 8;
+  if ((color == WHITE && ep_rank != 5) || (color == BLACK && ep_rank != 2))
+    return;
+
+  Couleur opponent = (color == WHITE) ? BLACK : WHITE;
+  Bitboard ep_attackers =
+      pawn_attacks(opponent, board->en_passant) & board->pieces[color][PAWN];
+  while (ep_attackers) {
+    Square from = __builtin_ctzll(ep_attackers);
+    ep_attackers &= ep_attackers - 1;
+
+    Move ep_move = create_move(from, board->en_passant, MOVE_EN_PASSANT);
+    if (is_move_legal(board, &ep_move))
+      movelist_add(moves, ep_move);
+  }
+}
+
+// Roque légal (le roi n'est pas en échec, vérifié par l'appelant)
+static int can_castle(const Board *board, Couleur color, Square king_sq,
+                      int is_kingside) {
+  int right = is_kingside
+                  ? (color == WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE)
+                  : (color == WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE);
+  if (!(board->castle_rights & right))
+    return 0;
+
+  Square home = (color == WHITE) ? E1 : E8;
+  Square rook_sq = is_kingside ? (color == WHITE ? H1 : H8)
+                               : (color == WHITE ? A1 : A8);
+  if (king_sq != home || !GET_BIT(board->pieces[color][ROOK], rook_sq))
+    return 0;
+
+  // Cases entre roi et tour vides
+  if (between_squares(king_sq, rook_sq) & board->all_pieces)
+    return 0;
+
+  // Cases de passage et d'arrivée du roi non attaquées
+  Couleur opponent = (color == WHITE) ? BLACK : WHITE;
+  Square passage_square = is_kingside ? king_sq + 1 : king_sq - 1;
+  Square king_dest = is_kingside ? king_sq + 2 : king_sq - 2;
+  return !is_square_attacked(board, passage_square, opponent) &&
+         !is_square_attacked(board, king_dest, opponent);
+}
+
+static void add_legal_castle(const Board *board, Couleur color, Square king_sq,
+                             int is_kingside, MoveList *moves) {
+  if (can_castle(board, color, king_sq, is_kingside)) {
+    Square king_dest = is_kingside ? king_sq + 2 : king_sq - 2;
+    movelist_add(moves, create_move(king_sq, king_dest, MOVE_CASTLE));
+  }
+}
+
+// Coup tactique : capture, prise en passant ou promotion
+static int is_noisy_type(const Move *move) {
+  return (MOVE_FLAGS(*move) & (MOVE_FLAG_CAPTURE | MOVE_FLAG_PROMOTION)) != 0;
+}
+
+// Génération de mouvements légaux uniquement : échecs et clouages calculés
+// une fois par position, puis seuls les coups légaux (du type demandé) sont
+// émis. Les captures visent les cases adverses, les coups calmes les cases
+// vides
+static void generate_legal_by_kind(const Board *board, MoveList *moves,
+                                   MoveGenKind kind) {
+  if (!moves || !board)
+    return;
+
+  Couleur color = board->to_move;
+  Couleur opponent = (color == WHITE) ? BLACK : WHITE;
+  Bitboard kings = board->pieces[color][KING];
+
+  // Position anormale sans roi : retomber sur le filtrage make/test
+  if (kings == 0) {
+    generate_moves(board, moves);
+    filter_legal_moves(board, moves);
+    if (kind != GEN_ALL) {
+      int kept = 0;
+      for (int i = 0; i < moves->count; i++) {
+        if (is_noisy_type(&moves->moves[i]) == (kind == GEN_NOISY))
+          moves->moves[kept++] = moves->moves[i];
+      }
+      moves->count = kept;
+    }
+    return;
+  }
+
+  movelist_init(moves);
+
+  Square king_sq = __builtin_ctzll(kings);
+  Bitboard own = board->occupied[color];
+  Bitboard enemies = board->occupied[opponent];
+  Bitboard checkers = attackers_to(board, king_sq, board->all_pieces) & enemies;
+
+  // Cases d'arrivée autorisées selon le type de génération
+  Bitboard kind_mask = (kind == GEN_NOISY)   ? enemies
+                       : (kind == GEN_QUIET) ? ~board->all_pieces
+                                             : ~own;
+
+  // 1. Roi : le roi est retiré de l'occupation pour qu'il ne masque pas les
+  // rayons qui le visent (il ne peut pas reculer sur la ligne d'un échec)
+  Bitboard occupancy_without_king = board->all_pieces & ~kings;
+  Bitboard king_targets = king_attacks(king_sq) & kind_mask;
+  while (king_targets) {
+    Square to = __builtin_ctzll(king_targets);
+    king_targets &= king_targets - 1;
+
+    if (attackers_to(board, to, occupancy_without_king) & enemies)
+      continue;
+
+    if (GET_BIT(enemies, to)) {
+      movelist_add(moves, create_move(king_sq, to, MOVE_CAPTURE));
+    } else {
+      movelist_add(moves, create_move(king_sq, to, MOVE_NORMAL));
+    }
+  }
+
+  // 2. Double échec : seul le roi peut bouger
+  if (checkers & (checkers - 1))
+    return;
+
+  // 3. Échec simple : capturer la pièce ou s'interposer
+  Bitboard check_mask = ~0ULL;
+  if (checkers) {
+    check_mask =
+        checkers | between_squares(king_sq, __builtin_ctzll(checkers));
+  }
+
+  Bitboard pinned = pinned_pieces(board, color, king_sq);
+
+  // 4. Pions
+  generate_legal_pawn_moves(board, color, king_sq, check_mask, pinned, kind,
+                            moves);
+
+  // 5. Pièces : un cavalier cloué ne peut jamais bouger, les autres restent
+  // sur la ligne du clouage
+  for (PieceType piece = KNIGHT; piece <= QUEEN; piece++) {
+    Bitboard pieces = board->pieces[color][piece];
+    if (piece == KNIGHT)
+      pieces &= ~pinned;
+
+    while (pieces) {
+      Square from = __builtin_ctzll(pieces);
+      pieces &= pieces - 1;
+
+      Bitboard targets;
+      switch (piece) {
+      case KNIGHT:
+        targets = knight_attacks(from);
+        break;
+      case BISHOP:
+        targets = bishop_attacks(from, board->all_pieces);
+        break;
+      case ROOK:
+        targets = rook_attacks(from, board->all_pieces);
+        break;
+      default:
+        targets = queen_attacks(from, board->all_pieces);
+        break;
+      }
+
+      targets &= kind_mask & check_mask;
+      if (GET_BIT(pinned, from))
+        targets &= line_through(king_sq, from);
+      add_target_moves(board, from, targets, moves);
+    }
+  }
+
+  // 6. Roques (interdits en échec)
+  if (!checkers && kind != GEN_NOISY) {
+    add_legal_castle(board, color, king_sq, 1, moves);
+    add_legal_castle(board, color, king_sq, 0, moves);
+  }
+
+#ifdef DEBUG
+  fprintf(stderr, "[DEBUG LEGAL] %d legal moves (checkers=%d, pinned=%d)\n",
+          moves->count, __builtin_popcountll(checkers),
+          __builtin_popcountll(pinned));
+#endif
+}
+
 void generate_legal_moves(const Board *board, MoveList *moves) {
-  generate_moves(board, moves);
-  filter_legal_moves(board, moves);
+  generate_legal_by_kind(board, moves, GEN_ALL);
+}
+
+// Captures, prises en passant et promotions (y compris sous-promotions et
+// promotions sans capture) : seuls coups cherchés par la quiescence
+void generate_noisy_moves(const Board *board, MoveList *moves) {
+  generate_legal_by_kind(board, moves, GEN_NOISY);
+}
+
+// Complément exact de generate_noisy_moves : poussées, coups de pièces vers
+// une case vide et roques
+void generate_quiet_moves(const Board *board, MoveList *moves) {
+  generate_legal_by_kind(board, moves, GEN_QUIET);
+}
+
+// Vérifie qu'un coup venant d'ailleurs (table de transposition, killer) est
+// jouable dans cette position sans générer la liste : bonne pièce, bon type,
+// trajectoire libre. Ne teste pas l'échec au roi (voir is_move_legal)
+int is_move_pseudo_legal(const Board *board, const Move *move) {
+  Square from = MOVE_FROM(*move);
+  Square to = MOVE_TO(*move);
+  if (from == to)
+    return 0;
+  // Drapeaux hors des combinaisons produites par create_move (TT corrompue)
+  if (!MOVE_IS_PROMOTION(*move) && *move != create_move(from, to, MOVE_TYPE(*move)))
+    return 0;
+
+  Couleur color = board->to_move;
+  Couleur opponent = (color == WHITE) ? BLACK : WHITE;
+  if (!GET_BIT(board->occupied[color], from) ||
+      GET_BIT(board->occupied[color], to))
+    return 0;
+
+  PieceType piece = get_piece_type(board, from);
+  int is_enemy = GET_BIT(board->occupied[opponent], to);
+  Bitboard to_bb = 1ULL << to;
+  Bitboard promotion_rank = (color == WHITE) ? 0xFF00000000000000ULL
+                                             : 0x00000000000000FFULL;
+
+  switch (MOVE_TYPE(*move)) {
+  case MOVE_CASTLE:
+    return piece == KING && !is_in_check(board, color) &&
+           (to == from + 2 || to + 2 == from) &&
+           can_castle(board, color, from, to > from);
+
+  case MOVE_EN_PASSANT:
+    return piece == PAWN && board->en_passant != NO_SQUARE &&
+           to == board->en_passant &&
+           (pawn_attacks(color, from) & to_bb);
+
+  case MOVE_CAPTURE:
+  case MOVE_NORMAL:
+  case MOVE_PROMOTION:
+    break;
+
+  default:
+    return 0;
+  }
+
+  // Le drapeau de capture doit correspondre au contenu de la case
+  if (MOVE_IS_CAPTURE(*move) != is_enemy)
+    return 0;
+
+  if (piece == PAWN) {
+    // Promotion obligatoire (et seulement) sur la dernière rangée
+    int on_last_rank = (promotion_rank & to_bb) != 0;
+    if (on_last_rank != (MOVE_TYPE(*move) == MOVE_PROMOTION))
+      return 0;
+
+    if (is_enemy)
+      return (pawn_attacks(color, from) & to_bb) != 0;
+
+    int direction = (color == WHITE) ? 8 : -8;
+    if ((int)to == (int)from + direction)
+      return 1; // Case d'arrivée vide déjà vérifiée
+    Bitboard start_rank = (color == WHITE) ? 0x000000000000FF00ULL
+                                           : 0x00FF000000000000ULL;
+    return (int)to == (int)from + 2 * direction &&
+           GET_BIT(start_rank, from) &&
+           !GET_BIT(board->all_pieces, from + direction);
+  }
+
+  if (MOVE_TYPE(*move) == MOVE_PROMOTION)
+    return 0;
+
+  switch (piece) {
+  case KNIGHT:
+    return (knight_attacks(from) & to_bb) != 0;
+  case BISHOP:
+    return (bishop_attacks(from, board->all_pieces) & to_bb) != 0;
+  case ROOK:
+    return (rook_attacks(from, board->all_pieces) & to_bb) != 0;
+  case QUEEN:
+    return (queen_attacks(from, board->all_pieces) & to_bb) != 0;
+  case KING:
+    return (king_attacks(from) & to_bb) != 0;
+  default:
+    return 0;
+  }
 }
 
 // Détecte si la position est pat (aucun mouvement légal, roi pas en échec)
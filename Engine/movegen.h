@@ -12,14 +12,36 @@ typedef enum {
   MOVE_PROMOTION = 4   // Promotion de pion
 } MoveType;
 
-// Structure d'un coup - Simple et claire
-typedef struct {
-  Square from;              // Case de départ
-  Square to;                // Case d'arrivée
-  MoveType type;            // Type de coup
-  PieceType promotion;      // Pièce de promotion (EMPTY si pas de promotion)
-  PieceType captured_piece; // Pièce capturée (EMPTY si pas de capture)
-} Move;
+// Coup compact sur 16 bits (listes, TT, killers) :
+//   bits 0-5   case de départ
+//   bits 6-11  case d'arrivée
+//   bits 12-15 drapeaux : 0x4 capture, 0x8 promotion ; les 2 bits bas
+//              donnent la pièce promue (0=N 1=B 2=R 3=Q) pour une promotion,
+//              sinon 1 = en passant (avec 0x4) et 2 = roque
+// La pièce capturée n'est pas stockée : elle se lit sur le plateau avant le
+// coup (voir move_captured_piece)
+typedef uint16_t Move;
+
+#define MOVE_NONE ((Move)0) // a1a1 : jamais un coup valide
+
+#define MOVE_FLAG_CAPTURE 0x4
+#define MOVE_FLAG_PROMOTION 0x8
+#define MOVE_FLAGS_EN_PASSANT (MOVE_FLAG_CAPTURE | 0x1)
+#define MOVE_FLAGS_CASTLE 0x2
+
+#define MOVE_FROM(m) ((Square)((m)&0x3F))
+#define MOVE_TO(m) ((Square)(((m) >> 6) & 0x3F))
+#define MOVE_FLAGS(m) ((m) >> 12)
+#define MOVE_IS_CAPTURE(m) ((MOVE_FLAGS(m) & MOVE_FLAG_CAPTURE) != 0)
+#define MOVE_IS_PROMOTION(m) ((MOVE_FLAGS(m) & MOVE_FLAG_PROMOTION) != 0)
+#define MOVE_PROMOTION_PIECE(m)                                                \
+  (MOVE_IS_PROMOTION(m) ? (PieceType)(KNIGHT + (MOVE_FLAGS(m) & 0x3)) : EMPTY)
+#define MOVE_TYPE(m)                                                           \
+  (MOVE_IS_PROMOTION(m)                           ? MOVE_PROMOTION             \
+   : MOVE_FLAGS(m) == MOVE_FLAGS_EN_PASSANT       ? MOVE_EN_PASSANT            \
+   : MOVE_FLAGS(m) == MOVE_FLAGS_CASTLE           ? MOVE_CASTLE                \
+   : MOVE_IS_CAPTURE(m)                           ? MOVE_CAPTURE               \
+                                                  : MOVE_NORMAL)
 
 // Liste de coups pour la génération
 typedef struct {
@@ -32,7 +54,10 @@ typedef struct {
 void movelist_init(MoveList *list);
 void movelist_add(MoveList *list, Move move);
 Move create_move(Square from, Square to, MoveType type);
-Move create_promotion_move(Square from, Square to, PieceType promotion);
+Move create_promotion_move(Square from, Square to, PieceType promotion,
+                           int is_capture);
+// Pièce prise par le coup, lue sur le plateau AVANT de le jouer
+PieceType move_captured_piece(const Board *board, Move move);
 
 // Génération de coups
 void generate_moves(const Board *board, MoveList *moves);
@@ -48,17 +73,38 @@ int is_square_attacked(const Board *board, Square square,
                        Couleur attacking_color);
 int is_in_check(const Board *board, Couleur color);
 
+// Toutes les pièces (deux couleurs) attaquant une case pour une occupation
+// donnée (réutilisable par le SEE et l'évaluation)
+Bitboard attackers_to(const Board *board, Square square, Bitboard occupancy);
+
 // Mouvements légaux et fin de partie
 void generate_legal_moves(const Board *board, MoveList *moves);
+// Partition des coups légaux : tactiques (captures, en passant, promotions)
+// et calmes ; les deux listes réunies donnent generate_legal_moves
+void generate_noisy_moves(const Board *board, MoveList *moves);
+void generate_quiet_moves(const Board *board, MoveList *moves);
 int is_move_legal(const Board *board, const Move *move);
+int is_move_pseudo_legal(const Board *board, const Move *move);
 void filter_legal_moves(const Board *board, MoveList *moves);
 int is_stalemate(const Board *board);
 int is_checkmate(const Board *board);
 int is_fifty_move_rule(const Board *board);
 
-// Fonctions make/unmake temporaires pour la recherche
-void make_move_temp(Board *board, const Move *move, Board *backup);
-void unmake_move_temp(Board *board, const Board *backup);
+// Ce que make_move ne peut pas reconstruire : de quoi annuler un coup sans
+// copier tout le Board
+typedef struct {
+  PieceType captured_piece; // Pièce capturée (EMPTY si aucune)
+  int castle_rights;        // Droits de roque avant le coup
+  Square en_passant;        // Case en passant avant le coup
+  int halfmove_clock;       // Compteur des 50 coups avant le coup
+  uint64_t zobrist_key;     // Clé Zobrist avant le coup
+} UndoInfo;
+
+// make/unmake sur place pour la recherche et le perft
+void make_move(Board *board, const Move *move, UndoInfo *undo);
+void unmake_move(Board *board, const Move *move, const UndoInfo *undo);
+void make_null_move(Board *board, UndoInfo *undo);
+void unmake_null_move(Board *board, const UndoInfo *undo);
 
 // Résultat de partie
 typedef enum {
@@ -76,20 +122,16 @@ GameResult get_game_result(const Board *board);
 // void print_movelist(const MoveList *list);
 // char *move_to_string(const Move *move);
 
-#define ADD_PROMOTIONS(from, to, captured, moves)                              \
+#define ADD_PROMOTIONS(from, to, is_capture, moves)                            \
   do {                                                                         \
-    Move promoQ = create_promotion_move((from), (to), QUEEN);                  \
-    promoQ.captured_piece = (captured);                                        \
-    movelist_add((moves), promoQ);                                             \
-    Move promoR = create_promotion_move((from), (to), ROOK);                   \
-    promoR.captured_piece = (captured);                                        \
-    movelist_add((moves), promoR);                                             \
-    Move promoB = create_promotion_move((from), (to), BISHOP);                 \
-    promoB.captured_piece = (captured);                                        \
-    movelist_add((moves), promoB);                                             \
-    Move promoN = create_promotion_move((from), (to), KNIGHT);                 \
-    promoN.captured_piece = (captured);                                        \
-    movelist_add((moves), promoN);                                             \
+    movelist_add((moves),                                                      \
+                 create_promotion_move((from), (to), QUEEN, (is_capture)));   \
+    movelist_add((moves),                                                      \
+                 create_promotion_move((from), (to), ROOK, (is_capture)));    \
+    movelist_add((moves),                                                      \
+                 create_promotion_move((from), (to), BISHOP, (is_capture)));  \
+    movelist_add((moves),                                                      \
+                 create_promotion_move((from), (to), KNIGHT, (is_capture)));  \
   } while (0)
 
 #endif // MOVEGEN_H
@@ -1,18 +1,136 @@
 #include "perft.h"
 #include "utils.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <time.h>
+
+// Macro pour logs de debug conditionnels
+#ifdef DEBUG
+#define DEBUG_LOG(...) fprintf(stderr, "[PERFT] " __VA_ARGS__)
+#else
+#define DEBUG_LOG(...)
+#endif
 
 // Variable globale pour activer les traces de debug
 int perft_debug = 0;
 
+// ========== TABLE DE HACHAGE DU PERFT ==========
+
+#define PERFT_CACHE_LINE_SIZE 64
+#define PERFT_BUCKET_SIZE 4
+
+// Nombre de positions stocké au-dessus des 8 bits de profondeur
+#define PERFT_MAX_STORED_NODES (UINT64_MAX >> 8)
+
+// Entrée de 16 octets partagée sans verrou entre les threads. Les données
+// sont (nodes << 8) | depth (0 = entrée vide) ; la clé est stockée XOR les
+// données comme dans la table de transposition : une entrée déchirée ne
+// vérifie plus aucune clé. La clé complète (64 bits) et la profondeur
+// restante doivent correspondre, le compte reste donc exact
+typedef struct {
+  _Atomic uint64_t key_xor_data;
+  _Atomic uint64_t data;
+} PerftEntry;
+
+typedef struct {
+  PerftEntry entry[PERFT_BUCKET_SIZE];
+} __attribute__((aligned(PERFT_CACHE_LINE_SIZE))) PerftBucket;
+
+static void *perft_hash_memory;
+static PerftBucket *perft_buckets;
+static size_t perft_bucket_count; // 0 : table désactivée
+
+size_t perft_set_hash_size(size_t size_mb) {
+  free(perft_hash_memory);
+  perft_hash_memory = NULL;
+  perft_buckets = NULL;
+  perft_bucket_count = 0;
+
+  if (size_mb > PERFT_MAX_HASH_MB)
+    size_mb = PERFT_MAX_HASH_MB;
+
+  // Même stratégie que la table de transposition : calloc aligné, taille
+  // divisée par 2 en cas d'échec
+  for (; size_mb >= 1; size_mb /= 2) {
+    size_t count = (size_mb << 20) / sizeof(PerftBucket);
+    perft_hash_memory =
+        calloc(1, count * sizeof(PerftBucket) + PERFT_CACHE_LINE_SIZE);
+    if (perft_hash_memory) {
+      uintptr_t aligned =
+          ((uintptr_t)perft_hash_memory + PERFT_CACHE_LINE_SIZE - 1) &
+          ~(uintptr_t)(PERFT_CACHE_LINE_SIZE - 1);
+      perft_buckets = (PerftBucket *)aligned;
+      perft_bucket_count = count;
+      break;
+    }
+    DEBUG_LOG("Table perft : échec d'allocation de %zu MB\n", size_mb);
+  }
+  return perft_bucket_count ? size_mb : 0;
+}
+
+static inline PerftBucket *perft_bucket(uint64_t key) {
+  return &perft_buckets[((__uint128_t)key * perft_bucket_count) >> 64];
+}
+
+static int perft_hash_probe(uint64_t key, int depth, unsigned long *nodes) {
+  PerftBucket *bucket = perft_bucket(key);
+  for (int i = 0; i < PERFT_BUCKET_SIZE; i++) {
+    uint64_t data =
+        atomic_load_explicit(&bucket->entry[i].data, memory_order_relaxed);
+    uint64_t key_xor_data = atomic_load_explicit(
+        &bucket->entry[i].key_xor_data, memory_order_relaxed);
+    if (data != 0 && (key_xor_data ^ data) == key &&
+        (int)(data & 0xFF) == depth) {
+      *nodes = (unsigned long)(data >> 8);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Remplace l'entrée la moins profonde du bucket (les sous-arbres profonds
+// sont les plus coûteux à recalculer)
+static void perft_hash_store(uint64_t key, int depth, unsigned long nodes) {
+  if ((uint64_t)nodes > PERFT_MAX_STORED_NODES)
+    return;
+
+  PerftBucket *bucket = perft_bucket(key);
+  int victim = 0;
+  int victim_depth = INT32_MAX;
+  for (int i = 0; i < PERFT_BUCKET_SIZE; i++) {
+    int entry_depth = (int)(atomic_load_explicit(&bucket->entry[i].data,
+                                                 memory_order_relaxed) &
+                            0xFF);
+    if (entry_depth < victim_depth) {
+      victim = i;
+      victim_depth = entry_depth;
+    }
+  }
+
+  uint64_t data = ((uint64_t)nodes << 8) | (uint64_t)depth;
+  atomic_store_explicit(&bucket->entry[victim].key_xor_data, key ^ data,
+                        memory_order_relaxed);
+  atomic_store_explicit(&bucket->entry[victim].data, data,
+                        memory_order_relaxed);
+}
+
+// ========== PERFT ==========
+
 // Fonction perft : compte toutes les positions légales jusqu'à depth
 // Optimisée avec bulk counting à depth 1
 unsigned long perft(Board *board, int depth) {
   if (depth == 0)
     return 1;
 
+  // Sous-arbre déjà compté (la profondeur 1 est plus rapide à recompter)
+  unsigned long cached;
+  int hashed = perft_bucket_count > 0 && depth >= 2;
+  if (hashed && perft_hash_probe(board->zobrist_key, depth, &cached))
+    return cached;
+
   MoveList moves;
   generate_legal_moves(board, &moves);
 
@@ -37,64 +155,223 @@ unsigned long perft(Board *board, int depth) {
 
   unsigned long nodes = 0;
   for (int i = 0; i < moves.count; i++) {
-    Board
-        backup; // Déclaré mais NON initialisé - sera rempli par make_move_temp
-    make_move_temp(board, &moves.moves[i], &backup);
+    UndoInfo undo;
+#ifdef DEBUG
+    // Cohérence make/unmake : le plateau doit revenir identique à la copie
+    Board reference = *board;
+#endif
+    make_move(board, &moves.moves[i], &undo);
     nodes += perft(board, depth - 1);
-    *board = backup; // Restaure avec le backup créé par make_move_temp
+    unmake_move(board, &moves.moves[i], &undo);
+#ifdef DEBUG
+    if (memcmp(&reference, board, sizeof(Board)) != 0) {
+      printf("[PERFT] unmake_move incohérent pour %s\n",
+             move_to_string(&moves.moves[i]));
+      *board = reference;
+    }
+#endif
   }
 
+  if (hashed)
+    perft_hash_store(board->zobrist_key, depth, nodes);
   return nodes;
 }
 
+// ========== PERFT MULTI-THREAD ==========
+
+// Tâche élémentaire : un coup de la racine, suivi d'une réponse quand la
+// racine est découpée à deux demi-coups
+typedef struct {
+  int root_index;     // Indice du coup de la racine
+  Move reply;         // Réponse jouée après lui (MOVE_NONE : aucune)
+  uint64_t nodes;     // Résultat
+  long elapsed_ms;    // Temps passé sur la tâche
+} PerftTask;
+
+// Travail partagé entre les threads : chacun prend la tâche suivante
+typedef struct {
+  const Board *board;
+  const MoveList *root_moves;
+  PerftTask *tasks;
+  int task_count;
+  int depth;
+  atomic_int next_task;
+} PerftJob;
+
+static void *perft_worker(void *arg) {
+  PerftJob *job = (PerftJob *)arg;
+  Board board = *job->board; // Copie propre au thread
+
+  for (;;) {
+    int t = atomic_fetch_add_explicit(&job->next_task, 1, memory_order_relaxed);
+    if (t >= job->task_count)
+      break;
+
+    PerftTask *task = &job->tasks[t];
+    const Move *root_move = &job->root_moves->moves[task->root_index];
+    long start_ms = get_time_ms();
+    UndoInfo root_undo, reply_undo;
+
+    make_move(&board, root_move, &root_undo);
+    if (task->reply == MOVE_NONE) {
+      task->nodes = perft(&board, job->depth - 1);
+    } else {
+      make_move(&board, &task->reply, &reply_undo);
+      task->nodes = perft(&board, job->depth - 2);
+      unmake_move(&board, &task->reply, &reply_undo);
+    }
+    unmake_move(&board, root_move, &root_undo);
+
+    task->elapsed_ms = get_time_ms() - start_ms;
+  }
+  return NULL;
+}
+
+// Découpe la racine en tâches : un coup par tâche, ou un couple (coup,
+// réponse) quand plusieurs threads cherchent à profondeur 3 ou plus (la
+// racine seule compte trop peu de coups pour équilibrer la charge)
+static int perft_build_tasks(Board *board, int depth, int threads,
+                             const MoveList *root_moves, PerftTask *tasks) {
+  int count = 0;
+  int split_replies = threads > 1 && depth >= 3;
+
+  for (int i = 0; i < root_moves->count; i++) {
+    if (!split_replies) {
+      tasks[count++] = (PerftTask){i, MOVE_NONE, 0, 0};
+      continue;
+    }
+
+    // Pas de réponse (mat ou pat) : aucune tâche, le coup compte 0
+    MoveList replies;
+    UndoInfo undo;
+    make_move(board, &root_moves->moves[i], &undo);
+    generate_legal_moves(board, &replies);
+    unmake_move(board, &root_moves->moves[i], &undo);
+
+    for (int j = 0; j < replies.count; j++)
+      tasks[count++] = (PerftTask){i, replies.moves[j], 0, 0};
+  }
+  return count;
+}
+
+uint64_t perft_split(Board *board, int depth, int threads,
+                     const MoveList *root_moves, uint64_t *counts,
+                     long *elapsed_ms) {
+  if (threads < 1)
+    threads = 1;
+  if (threads > PERFT_MAX_THREADS)
+    threads = PERFT_MAX_THREADS;
+
+  for (int i = 0; i < root_moves->count; i++) {
+    counts[i] = 0;
+    if (elapsed_ms)
+      elapsed_ms[i] = 0;
+  }
+  if (depth < 1 || root_moves->count == 0)
+    return 0;
+
+  // Au plus 256 coups à la racine et 256 réponses à chacun
+  PerftTask *tasks =
+      malloc(sizeof(PerftTask) * (size_t)root_moves->count * 256);
+  if (!tasks) {
+    DEBUG_LOG("Allocation des tâches impossible, perft séquentiel\n");
+    uint64_t total = 0;
+    for (int i = 0; i < root_moves->count; i++) {
+      UndoInfo undo;
+      make_move(board, &root_moves->moves[i], &undo);
+      counts[i] = perft(board, depth - 1);
+      unmake_move(board, &root_moves->moves[i], &undo);
+      total += counts[i];
+    }
+    return total;
+  }
+
+  PerftJob job = {.board = board,
+                  .root_moves = root_moves,
+                  .tasks = tasks,
+                  .task_count = perft_build_tasks(board, depth, threads,
+                                                  root_moves, tasks),
+                  .depth = depth};
+  atomic_init(&job.next_task, 0);
+
+  if (threads > job.task_count)
+    threads = job.task_count > 0 ? job.task_count : 1;
+
+  // Le thread appelant travaille aussi
+  pthread_t handles[PERFT_MAX_THREADS];
+  int started[PERFT_MAX_THREADS] = {0};
+  for (int i = 1; i < threads; i++) {
+    started[i] = (pthread_create(&handles[i], NULL, perft_worker, &job) == 0);
+    if (!started[i]) {
+      DEBUG_LOG("Échec de création du thread %d\n", i);
+    }
+  }
+  perft_worker(&job);
+  for (int i = 1; i < threads; i++) {
+    if (started[i])
+      pthread_join(handles[i], NULL);
+  }
+
+  uint64_t total = 0;
+  for (int t = 0; t < job.task_count; t++) {
+    counts[tasks[t].root_index] += tasks[t].nodes;
+    if (elapsed_ms)
+      elapsed_ms[tasks[t].root_index] += tasks[t].elapsed_ms;
+    total += tasks[t].nodes;
+  }
+
+  free(tasks);
+  return total;
+}
+
+// ========== AFFICHAGE ==========
+
 // Fonction perft_divide : affiche le nombre de positions pour chaque coup
-void perft_divide(Board *board, int depth) {
+uint64_t perft_divide(Board *board, int depth, int threads) {
   MoveList moves;
   generate_legal_moves(board, &moves);
 
-  for (int i = 0; i < moves.count; i++) {
-    Board backup;
-    make_move_temp(board, &moves.moves[i], &backup);
-    unsigned long count = perft(board, depth - 1);
-    *board = backup;
+  uint64_t counts[256];
+  uint64_t total = perft_split(board, depth, threads, &moves, counts, NULL);
 
+  for (int i = 0; i < moves.count; i++) {
     char *move_str = move_to_string(&moves.moves[i]);
-    printf("%s: %lu\n", move_str, count);
+    printf("%s: %" PRIu64 "\n", move_str, counts[i]);
   }
+  return total;
 }
 
 // Fonction perft_test : test complet avec statistiques de performance
-void perft_test(Board *board, int depth) {
+void perft_test(Board *board, int depth, int threads) {
   printf("\n=== PERFT TEST ===\n");
-  printf("Depth: %d\n\n", depth);
+  printf("Depth: %d\n", depth);
+  printf("Threads: %d\n\n", threads);
 
-  clock_t start = clock();
+  // Temps réel (clock() additionnerait le temps CPU de tous les threads)
+  long start = get_time_ms();
 
   MoveList moves;
   generate_legal_moves(board, &moves);
-  unsigned long total = 0;
+  uint64_t counts[256];
+  long move_ms[256];
+  uint64_t total =
+      perft_split(board, depth, threads, &moves, counts, move_ms);
 
-  // Afficher chaque coup avec son nombre de nodes
-  for (int i = 0; i < moves.count; i++) {
-    Board backup;
-    make_move_temp(board, &moves.moves[i], &backup);
-    unsigned long count = perft(board, depth - 1);
-    *board = backup;
+  long elapsed_ms = get_time_ms() - start;
 
+  // Afficher chaque coup avec son nombre de nodes et le temps passé dessus
+  // (somme sur les threads qui s'en sont chargés)
+  for (int i = 0; i < moves.count; i++) {
     char *move_str = move_to_string(&moves.moves[i]);
-    printf("%-6s: %lu\n", move_str, count);
-    total += count;
+    printf("%-6s: %" PRIu64 " (%ld ms)\n", move_str, counts[i], move_ms[i]);
   }
 
-  clock_t end = clock();
-  double elapsed_ms = (double)(end - start) / CLOCKS_PER_SEC * 1000.0;
-
   // Statistiques finales
   printf("\n=== RESULTS ===\n");
-  printf("Nodes: %lu\n", total);
-  printf("Time:  %.0f ms\n", elapsed_ms);
+  printf("Nodes: %" PRIu64 "\n", total);
+  printf("Time:  %ld ms\n", elapsed_ms);
   if (elapsed_ms > 0) {
-    printf("NPS:   %.0f\n", total / (elapsed_ms / 1000.0));
+    printf("NPS:   %" PRIu64 "\n", total * 1000 / (uint64_t)elapsed_ms);
   }
   printf("\n");
 }
@@ -3,18 +3,40 @@
 
 #include "board.h"
 #include "movegen.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Nombre maximal de threads d'un perft
+#define PERFT_MAX_THREADS 256
+
+// Taille maximale de la table de hachage du perft en MB
+#define PERFT_MAX_HASH_MB 1048576
 
 // Variable globale pour activer les traces de debug
 extern int perft_debug;
 
+// (Ré)alloue la table de hachage du perft, vide, partagée par perft et
+// perft_split (0 : désactivée, libérée). Retourne la taille obtenue en MB
+size_t perft_set_hash_size(size_t size_mb);
+
 // Compte toutes les positions légales jusqu'à depth
-// Optimisée avec bulk counting à depth 1
+// Optimisée avec bulk counting à depth 1 et, si elle est allouée, la table
+// de hachage du perft à partir de depth 2
 unsigned long perft(Board *board, int depth);
 
-// Affiche le nombre de positions pour chaque coup (sans stats)
-void perft_divide(Board *board, int depth);
+// Perft réparti entre threads : les coups de la racine (et leurs réponses à
+// partir de depth 3) sont distribués à la demande. counts[i] reçoit le nombre
+// de positions sous root_moves->moves[i], elapsed_ms[i] (si non NULL) le
+// temps passé dessus. Retourne le total, identique à perft
+uint64_t perft_split(Board *board, int depth, int threads,
+                     const MoveList *root_moves, uint64_t *counts,
+                     long *elapsed_ms);
+
+// Affiche le nombre de positions pour chaque coup (sans stats), retourne le
+// total
+uint64_t perft_divide(Board *board, int depth, int threads);
 
-// Test complet avec statistiques (temps, NPS, nodes)
-void perft_test(Board *board, int depth);
+// Test complet avec statistiques (temps par coup, NPS, nodes)
+void perft_test(Board *board, int depth, int threads);
 
 #endif // PERFT_H
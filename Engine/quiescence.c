@@ -1,6 +1,7 @@
 #include "quiescence.h"
 #include "evaluation.h"
 #include "move_ordering.h"
+#include "search_helpers.h"
 #include "utils.h"
 #include <stdio.h>
 
@@ -13,19 +14,9 @@
 
 // ========== GÉNÉRATION DES CAPTURES ==========
 
+// Génération native (sans passer par la liste complète des coups légaux)
 void generate_capture_moves(const Board *board, MoveList *moves) {
-  MoveList all_moves;
-  generate_legal_moves(board, &all_moves);
-
-  movelist_init(moves);
-
-  for (int i = 0; i < all_moves.count; i++) {
-    if (all_moves.moves[i].type == MOVE_CAPTURE ||
-        all_moves.moves[i].type == MOVE_EN_PASSANT ||
-        all_moves.moves[i].type == MOVE_PROMOTION) {
-      movelist_add(moves, all_moves.moves[i]);
-    }
-  }
+  generate_noisy_moves(board, moves);
 }
 
 // ========== QUIESCENCE SEARCH ==========
@@ -37,6 +28,16 @@ int quiescence_search(Board *board, int alpha, int beta, Couleur color,
 
 int quiescence_search_depth(Board *board, int alpha, int beta, Couleur color,
                             int ply) {
+  // Noeud compté comme en negamax (nodes, nps, go nodes)
+  search_count_node();
+
+  // Arrêt demandé (stop, quit ou temps écoulé) : le résultat sera ignoré
+  if (SEARCH_STOPPED())
+    return 0;
+
+  if (ply > search_seldepth)
+    search_seldepth = ply;
+
   // Limite de profondeur pour éviter les boucles infinies
   if (ply >= 128) { // Sécurité maximale
     int score = evaluate_position(board);
@@ -53,6 +54,11 @@ int quiescence_search_depth(Board *board, int alpha, int beta, Couleur color,
   // evaluate_position returns from white's perspective, adjust for current player
   if (color == BLACK) stand_pat = -stand_pat;
 
+  // Camp au trait maté : score relatif au ply, pour que la distance au mat
+  // remonte jusqu'à la racine (info score mate N)
+  if (stand_pat == -MATE_SCORE)
+    stand_pat = -MATE_SCORE + ply;
+
   // Beta cutoff
   if (stand_pat >= beta) {
 #ifdef DEBUG
@@ -66,58 +72,38 @@ int quiescence_search_depth(Board *board, int alpha, int beta, Couleur color,
     alpha = stand_pat;
   }
 
-  // Générer uniquement les captures
-  MoveList capture_moves;
-  generate_capture_moves(board, &capture_moves);
-
-  // Pas de captures = position quiète
-  if (capture_moves.count == 0) {
-#ifdef DEBUG
-    DEBUG_LOG("[QUIESCENCE] Quiet position, stand_pat=%d\n", stand_pat);
-#endif
-    return stand_pat;
-  }
-
-  // Trier les captures par MVV-LVA
-  OrderedMoveList ordered_captures;
-  Move null_move = {.from = -1,
-                    .to = -1,
-                    .type = MOVE_NORMAL,
-                    .promotion = EMPTY,
-                    .captured_piece = EMPTY};
-  order_moves(board, &capture_moves, &ordered_captures, null_move, ply);
+  // Sélecteur paresseux limité aux captures et promotions : les captures
+  // sont triées au fur et à mesure (MVV-LVA) et les perdantes (SEE < 0)
+  // passent en dernier
+  MovePicker picker;
+  movepicker_init_qsearch(&picker, board);
 
   // Chercher dans les captures
-  for (int i = 0; i < ordered_captures.count; i++) {
-    // FIX: Utiliser une sauvegarde locale au lieu du stack partagé
-    // Cela évite la corruption quand quiescence_search est appelé depuis
-    // negamax
-    Board local_backup = *board;
-
-    // Appliquer le mouvement directement
-    Board dummy_backup;
-    make_move_temp(board, &ordered_captures.moves[i], &dummy_backup);
-
-    // Delta pruning - ignorer les captures très faibles
-    int delta = piece_value(ordered_captures.moves[i].captured_piece) + 300;
+  Move move;
+  while (movepicker_next(&picker, &move)) {
+    // Delta pruning - ignorer les captures très faibles (avant de jouer le
+    // coup)
+    int delta = piece_value(move_captured_piece(board, move)) + 300;
     if (stand_pat + delta < alpha) {
-      *board = local_backup; // Restaurer depuis le backup local
 #ifdef DEBUG
       DEBUG_LOG("[QUIESCENCE] Delta prune: stand_pat=%d delta=%d alpha=%d\n", stand_pat, delta, alpha);
 #endif
       continue;
     }
 
+    // Enregistrement d'annulation local (indépendant de la pile de negamax)
+    UndoInfo undo;
+    make_move(board, &move, &undo);
+
     // Recherche récursive
     Couleur opponent = (color == WHITE) ? BLACK : WHITE;
     int score =
         -quiescence_search_depth(board, -beta, -alpha, opponent, ply + 1);
 
-    // Restaurer le plateau depuis le backup local
-    *board = local_backup;
+    unmake_move(board, &move, &undo);
 
 #ifdef DEBUG
-    DEBUG_LOG("[QUIESCENCE] ply=%d move=%s score=%d\n", ply, move_to_string(&ordered_captures.moves[i]), score);
+    DEBUG_LOG("[QUIESCENCE] ply=%d move=%s score=%d\n", ply, move_to_string(&move), score);
 #endif
 
     // Mise à jour alpha-beta
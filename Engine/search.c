@@ -1,9 +1,11 @@
 #include "search.h"
+#include <inttypes.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
 // Macro pour logs de debug conditionnels
 #ifdef DEBUG
@@ -17,11 +19,125 @@
 #define VERSION 10
 #endif
 
-// Variables globales pour gérer le temps de recherche
-static clock_t search_start_time;
-static int search_time_limit_ms;
-static volatile int search_should_stop;
-static long global_nodes_searched; // Global counter for all nodes explored
+// Variables globales pour gérer le temps de recherche (horloge monotone en
+// temps réel : le temps CPU avance N fois plus vite avec N threads)
+static atomic_long search_start_time_ms; // Début (info time, nps)
+static atomic_long search_clock_start_ms; // Origine des limites de temps
+                                          // (repart à zéro sur ponderhit)
+static SearchLimits search_limits;       // Temps, noeuds, mat, searchmoves
+static atomic_int search_pondering;      // Pas de limite de temps en ponder
+
+// Noeuds entre deux lectures de l'horloge (~1 ms à 1 Mnps) : le test par
+// noeud se réduit à un décrément
+#define TIME_CHECK_NODES 1024
+
+// Délai avant d'annoncer le coup de la racine en cours (info currmove)
+#define CURRMOVE_DELAY_MS 3000
+
+// Longueur maximale de la variation principale (profondeur max en plies)
+#define PV_MAX_LENGTH 128
+
+// Fenêtres d'aspiration à la racine (V4+) : demi-largeur initiale, doublée à
+// chaque échec, fenêtre complète au-delà du maximum
+#define ASPIRATION_MIN_DEPTH 5
+#define ASPIRATION_WINDOW 25
+#define ASPIRATION_MAX_WINDOW 500
+
+// ========== THREADS DE RECHERCHE (Lazy SMP) ==========
+
+// État propre à chaque thread : copie du plateau, compteur de noeuds publié
+// et résultat de sa dernière itération complète
+typedef struct {
+  int id; // 0 = thread principal (celui qui appelle la recherche)
+  pthread_t handle;
+  int started;
+  Board board;
+  int max_depth;
+  _Atomic uint64_t nodes; // Publié périodiquement pour les lignes info
+  int completed_depth;
+  Move best_move;
+  int best_score;
+  Move pv[PV_MAX_LENGTH]; // Variation principale de la dernière itération
+  int pv_length;
+  OrderingTables ordering; // Killers et history, gardés entre les recherches
+} SearchThread;
+
+static SearchThread search_threads[SEARCH_MAX_THREADS];
+static int search_thread_count = 1;
+
+// Ligne de la racine (MultiPV) : coup, score et variation principale
+typedef struct {
+  Move move;
+  int score;
+  Move pv[PV_MAX_LENGTH];
+  int pv_length;
+} RootLine;
+
+// Lignes du thread principal (option UCI MultiPV)
+static RootLine multipv_lines[SEARCH_MAX_MULTIPV];
+static int search_multipv = 1;
+
+// Pas de lignes info (bench : seuls les totaux sont affichés)
+static int search_silent = 0;
+
+static _Thread_local SearchThread *current_thread;
+static _Thread_local uint64_t thread_nodes_searched; // Noeuds de ce thread
+static _Thread_local int time_check_countdown;
+
+// Table triangulaire des variations principales : pv_table[ply] reçoit la
+// ligne trouvée depuis ply (coups pv_table[ply][ply..pv_length[ply]-1]),
+// remontée d'un ply à chaque coup qui améliore alpha dans un noeud PV
+static _Thread_local Move pv_table[PV_MAX_LENGTH + 1][PV_MAX_LENGTH + 1];
+static _Thread_local int pv_length[PV_MAX_LENGTH + 1];
+
+// La ligne du noeud ply devient move suivi de celle de l'enfant
+static inline void update_pv(int ply, Move move) {
+  pv_table[ply][ply] = move;
+  int length = pv_length[ply + 1];
+  for (int i = ply + 1; i < length; i++)
+    pv_table[ply][i] = pv_table[ply + 1][i];
+  pv_length[ply] = length > ply + 1 ? length : ply + 1;
+}
+
+// ========== LIMITES DE TEMPS ==========
+
+// Temps écoulé depuis le début de la recherche (lignes info)
+static int search_elapsed_ms(void) {
+  return (int)(get_time_ms() - atomic_load_explicit(&search_start_time_ms,
+                                                    memory_order_relaxed));
+}
+
+// Temps décompté du budget : depuis le début, ou depuis le ponderhit
+static int search_clock_elapsed_ms(void) {
+  return (int)(get_time_ms() - atomic_load_explicit(&search_clock_start_ms,
+                                                    memory_order_relaxed));
+}
+
+// Limite (souple ou dure) atteinte ? Jamais pendant le ponder
+static int time_limit_reached(int limit_ms) {
+  return limit_ms > 0 &&
+         !atomic_load_explicit(&search_pondering, memory_order_relaxed) &&
+         search_clock_elapsed_ms() >= limit_ms;
+}
+
+// Somme des noeuds de tous les threads (les helpers publient leur compteur
+// tous les TIME_CHECK_NODES noeuds, le thread appelant compte le sien en
+// direct)
+static uint64_t total_nodes_searched(void) {
+  uint64_t total = thread_nodes_searched;
+  for (int i = 0; i < search_thread_count; i++) {
+    if (&search_threads[i] != current_thread)
+      total += atomic_load_explicit(&search_threads[i].nodes,
+                                    memory_order_relaxed);
+  }
+  return total;
+}
+
+// Budget de noeuds (go nodes) épuisé ?
+static int node_limit_reached(void) {
+  return search_limits.nodes > 0 &&
+         total_nodes_searched() >= search_limits.nodes;
+}
 
 #if VERSION >= 3
 // V3: Table de transposition globale
@@ -33,64 +149,155 @@ static TranspositionTable tt_global;
 void initialize_engine(void) {
   DEBUG_LOG("=== INITIALISATION DU MOTEUR (V%d) ===\n", VERSION);
   init_zobrist();
+  init_attack_tables(); // Tables magic des pièces glissantes
 #if VERSION >= 9
-  init_killer_moves(); // V9: Killer Moves
+  // V9: Killer Moves (et history) de tous les threads, vidés à chaque
+  // nouvelle partie
+  for (int i = 0; i < SEARCH_MAX_THREADS; i++)
+    init_killer_moves(&search_threads[i].ordering);
 #endif
 #if VERSION >= 7
   init_lmr_table(); // V7: Late Move Reductions
 #endif
 #if VERSION >= 3
-  tt_init(&tt_global); // V3: Transposition Table
+  // V3: Transposition Table (vidée ; allouée au premier besoin pour garder
+  // une empreinte mémoire minimale au démarrage)
+  tt_clear(&tt_global);
 #endif
   DEBUG_LOG("=== MOTEUR PRÊT ===\n\n");
 }
 
+void search_reset_stop(void) {
+  atomic_store_explicit(&search_should_stop, 0, memory_order_relaxed);
+}
+
+void search_request_stop(void) {
+  atomic_store_explicit(&search_should_stop, 1, memory_order_relaxed);
+}
+
+void search_set_ponder(int pondering) {
+  atomic_store_explicit(&search_pondering, pondering, memory_order_relaxed);
+}
+
+void search_ponderhit(void) {
+  // Le budget de temps démarre maintenant : l'arbre déjà construit pendant
+  // le ponder (table de transposition) est conservé. Les lignes info
+  // gardent le début du ponder (temps et nps cohérents avec les noeuds)
+  atomic_store_explicit(&search_clock_start_ms, get_time_ms(),
+                        memory_order_relaxed);
+  atomic_store_explicit(&search_pondering, 0, memory_order_relaxed);
+}
+
+int search_set_threads(int count) {
+  if (count < 1)
+    count = 1;
+  if (count > SEARCH_MAX_THREADS)
+    count = SEARCH_MAX_THREADS;
+  search_thread_count = count;
+  return count;
+}
+
+int search_set_multipv(int count) {
+  if (count < 1)
+    count = 1;
+  if (count > SEARCH_MAX_MULTIPV)
+    count = SEARCH_MAX_MULTIPV;
+  search_multipv = count;
+  return count;
+}
+
+void search_set_silent(int silent) { search_silent = silent; }
+
+size_t search_set_hash_size(size_t size_mb) {
+#if VERSION >= 3
+  return tt_resize(&tt_global, size_mb);
+#else
+  return size_mb; // Pas de table avant V3
+#endif
+}
+
 // ========== NEGAMAX (V1: Alpha-Beta + Quiescence) ==========
 
+// Évaluation statique du point de vue du camp au trait, mise en cache dans
+// *cached (TT_EVAL_NONE tant qu'elle n'a pas été calculée)
+static inline int node_static_eval(const Board *board, Couleur color,
+                                   int *cached) {
+  if (*cached == TT_EVAL_NONE) {
+    int eval = evaluate_position(board);
+    // evaluate_position returns from white's perspective, adjust for current
+    // player
+    *cached = (color == BLACK) ? -eval : eval;
+  }
+  return *cached;
+}
+
+void search_count_node(void) {
+  thread_nodes_searched++;
+
+  // Tous les TIME_CHECK_NODES noeuds : publier le compteur et, pour le
+  // thread principal, vérifier la limite dure et le budget de noeuds
+  if (--time_check_countdown <= 0) {
+    time_check_countdown = TIME_CHECK_NODES;
+    if (current_thread != NULL) {
+      atomic_store_explicit(&current_thread->nodes, thread_nodes_searched,
+                            memory_order_relaxed);
+      if (current_thread->id == 0 &&
+          (time_limit_reached(search_limits.time.hard_ms) ||
+           node_limit_reached()))
+        search_request_stop();
+    }
+  }
+}
+
 int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
                        Couleur color, int ply, int in_null_move) {
-  // Increment global node counter
-  global_nodes_searched++;
+  search_count_node();
+  if (ply > search_seldepth)
+    search_seldepth = ply;
+
+  // Ligne vide tant qu'aucun coup n'améliore alpha (coupures, feuilles)
+  pv_length[ply] = ply;
 
   // (in_null_move est ignoré en V1)
   (void)in_null_move;
 
-  // Vérifier le temps tous les 2048 noeuds
-  static int node_count = 0;
-  if (++node_count >= 2048) {
-    node_count = 0;
-    if (search_time_limit_ms > 0) {
-      clock_t current = clock();
-      int elapsed_ms = (int)(((double)(current - search_start_time)) /
-                             CLOCKS_PER_SEC * 1000);
-      if (elapsed_ms >= search_time_limit_ms) {
-        search_should_stop = 1;
-      }
-    }
-  }
-
-  if (search_should_stop) {
+  if (SEARCH_STOPPED()) {
     return 0;
   }
 
   // Variables needed for TT (used conditionally)
 #if VERSION >= 3
-  uint64_t hash = zobrist_hash(board);
-  int tt_score;
-  TTEntry *tt_entry = tt_probe(&tt_global, hash, ply, &tt_score);
+  uint64_t hash = board->zobrist_key; // Maintenue par make_move
+  TTData tt_data;
+  int tt_hit = tt_probe(&tt_global, hash, ply, &tt_data);
+  int tt_score = tt_data.score;
 #else
   uint64_t hash = 0;
-  TTEntry *tt_entry = NULL;
-  (void)hash;     // Suppress unused warning
-  (void)tt_entry; // Suppress unused warning
+  TTData tt_data;
+  int tt_hit = 0;
+  (void)hash;    // Suppress unused warning
+  (void)tt_data; // Suppress unused warning
+  (void)tt_hit;  // Suppress unused warning
+#endif
+  // Noeud PV : fenêtre ouverte (mémorisé dans la TT)
+  int is_pv_node = (beta - alpha > 1);
+  (void)is_pv_node;
+
+  // Évaluation statique du noeud, calculée au plus une fois (reprise de la
+  // TT si elle y est déjà)
+  int static_eval = TT_EVAL_NONE;
+#if VERSION >= 3
+  if (tt_hit)
+    static_eval = tt_data.eval;
 #endif
+  (void)static_eval; // Inutilisée avant V3
 
 #if VERSION >= 3
   // V3: Transposition Table Probe
-  if (tt_entry != NULL && tt_entry->depth >= depth) {
-    if (tt_entry->type == TT_EXACT) {
+  if (tt_hit && tt_data.depth >= depth) {
+    if (tt_data.type == TT_EXACT) {
       return tt_score;
-    } else if (tt_entry->type == TT_LOWERBOUND) {
+    } else if (tt_data.type == TT_LOWERBOUND) {
       if (tt_score >= beta) {
         return tt_score;
       }
@@ -98,7 +305,7 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
       if (tt_score > alpha) {
         alpha = tt_score;
       }
-    } else if (tt_entry->type == TT_UPPERBOUND) {
+    } else if (tt_data.type == TT_UPPERBOUND) {
       if (tt_score <= alpha) {
         return tt_score;
       }
@@ -110,7 +317,7 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
   }
 #endif
 
-  if (ply >= 128) {
+  if (ply >= PV_MAX_LENGTH) {
     int eval = evaluate_position(board);
     // evaluate_position returns from white's perspective, adjust for current
     // player
@@ -135,11 +342,7 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
 #if VERSION >= 5
   // V5: Reverse Futility Pruning
   if (depth <= 2 && !is_in_check(board, color)) {
-    int static_eval = evaluate_position(board);
-    // evaluate_position returns from white's perspective, adjust for current
-    // player
-    if (color == BLACK)
-      static_eval = -static_eval;
+    node_static_eval(board, color, &static_eval);
     int rfp_margin = 150 * depth;
     if (static_eval - rfp_margin >= beta) {
 #ifdef DEBUG
@@ -157,9 +360,8 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
   if (depth >= 3 && !in_null_move && !is_in_check(board, color) &&
       has_non_pawn_material(board, color)) {
     // "Jouer" le coup nul
-    Board backup = *board;
-    board->to_move = (color == WHITE) ? BLACK : WHITE;
-    board->en_passant = -1;
+    UndoInfo null_undo;
+    make_null_move(board, &null_undo);
 
     // Réduction R : adaptative selon la profondeur
     // R=3 pour profondeur >= 6 (position stable, peut réduire plus)
@@ -169,7 +371,9 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
         -negamax_alpha_beta(board, depth - 1 - R, -beta, -beta + 1,
                             (color == WHITE) ? BLACK : WHITE, ply + 1, 1);
 
-    *board = backup; // Restaure l'état
+    unmake_null_move(board, &null_undo); // Restaure l'état
+    if (SEARCH_STOPPED())
+      return 0;
 
 #ifdef DEBUG
     DEBUG_LOG("[NEGAMAX] Null move prune? score=%d beta=%d ply=%d\n",
@@ -181,94 +385,41 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
   }
 #endif
 
-  MoveList moves;
-  generate_legal_moves(board, &moves);
-
-  if (moves.count == 0) {
-    if (is_in_check(board, color)) {
-      return -MATE_SCORE + ply; // Mat
-    } else {
-      return STALEMATE_SCORE; // Pat
-    }
-  }
-
-  // ========== FIX #1: VALIDATION DU HASH MOVE ==========
-  Move hash_move = {0};
-  int hash_move_valid = 0;
-
+  // Coup de la TT : le sélecteur le vérifie puis le joue avant toute
+  // génération (une coupure immédiate évite de générer les coups)
+  Move hash_move = MOVE_NONE;
 #if VERSION >= 3
-  // V3: Récupérer le meilleur coup de la TT pour le move ordering
-  if (tt_entry != NULL) {
-    Move candidate = tt_entry->best_move;
-
-    // ✅ VALIDER d'abord que le coup a des cases valides (0-63 pour un
-    // échiquier 8x8)
-    if (candidate.from >= 0 && candidate.from < 64 && candidate.to >= 0 &&
-        candidate.to < 64) {
-      // ✅ VALIDER que le coup est dans la liste des coups légaux
-      for (int i = 0; i < moves.count; i++) {
-        if (moves.moves[i].from == candidate.from &&
-            moves.moves[i].to == candidate.to &&
-            moves.moves[i].type == candidate.type &&
-            // Pour les promotions, vérifier aussi la pièce promue
-            (candidate.type != MOVE_PROMOTION ||
-             moves.moves[i].promotion == candidate.promotion)) {
-          hash_move = moves.moves[i]; // ✅ Coup complet validé
-          hash_move_valid = 1;
-#ifdef DEBUG
-          DEBUG_LOG("[TT] Hash move VALIDÉ: %s\n", move_to_string(&hash_move));
-#endif
-          break;
-        }
-      }
-    }
-
-#ifdef DEBUG
-    if (!hash_move_valid && (candidate.from != 0 || candidate.to != 0)) {
-      DEBUG_LOG("[TT] Hash move REJETÉ (illégal): from=%d to=%d\n",
-                candidate.from, candidate.to);
-    }
-#endif
+  if (tt_hit) {
+    hash_move = tt_data.best_move;
   }
 #endif
 
-#if VERSION >= 2
-  // V2: Move Ordering (utiliser hash_move seulement s'il est validé)
-  OrderedMoveList ordered_moves;
-  order_moves(board, &moves, &ordered_moves,
-              hash_move_valid ? hash_move : (Move){0}, ply);
-#else
-  // V1: Pas d'ordonnancement, utiliser l'ordre de génération
-  OrderedMoveList ordered_moves;
-  ordered_moves.count = moves.count;
-  for (int i = 0; i < moves.count; i++) {
-    ordered_moves.moves[i] = moves.moves[i];
-    ordered_moves.scores[i] = 0;
-  }
-#endif
+  // Sélecteur par étapes : coup TT, bonnes captures, killers, coups calmes
+  // (historique), mauvaises captures
+  MovePicker picker;
+  movepicker_init(&picker, board, hash_move, ply);
 
   int max_score = -INFINITY_SCORE;
-  Move best_move = {0};
+  Move best_move = MOVE_NONE;
   int alpha_orig = alpha;
 
 #if VERSION >= 10
   int static_eval_for_futility = -INFINITY_SCORE;
   int futility_pruning_active = (depth <= 2 && !is_in_check(board, color));
   if (futility_pruning_active) {
-    static_eval_for_futility = evaluate_position(board);
-    // evaluate_position returns from white's perspective, adjust for current
-    // player
-    if (color == BLACK)
-      static_eval_for_futility = -static_eval_for_futility;
+    static_eval_for_futility = node_static_eval(board, color, &static_eval);
   }
 #endif
 
-  for (int i = 0; i < ordered_moves.count; i++) {
+  Move move;
+  int move_count = 0; // Coups légaux déjà produits par le sélecteur
+  while (movepicker_next(&picker, &move)) {
+    int i = move_count++;
 #if VERSION >= 10
     // V10: Futility Pruning
     // Conditions strictes pour éviter de pruner des coups importants
     if (i >= 3 && // Laisser au moins 3 coups s'exécuter
-        futility_pruning_active && is_quiet_move(&ordered_moves.moves[i]) &&
+        futility_pruning_active && is_quiet_move(&move) &&
         abs(alpha) < MATE_SCORE - 100) { // Ne pas pruner près d'un mat
 
       int futility_margin = 200 * depth;
@@ -278,7 +429,7 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
     }
 #endif
 
-    apply_move(board, &ordered_moves.moves[i], ply);
+    apply_move(board, &move, ply);
     Couleur opponent = (color == WHITE) ? BLACK : WHITE;
     int score;
 
@@ -292,7 +443,7 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
 #if VERSION >= 7
       // V7: Late Move Reductions (LMR)
       int reduction = 0;
-      if (depth >= 3 && i >= 4 && is_quiet_move(&ordered_moves.moves[i])) {
+      if (depth >= 3 && i >= 4 && is_quiet_move(&move)) {
         reduction = get_lmr_reduction(depth, i);
       }
 
@@ -321,25 +472,33 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
     }
 #else
     // V1-V3: Recherche standard sans PVS
+    (void)i;
     score = -negamax_alpha_beta(board, depth - 1, -beta, -alpha, opponent,
                                 ply + 1, 0);
 #endif
 
     undo_move(board, ply);
 
+    // Recherche interrompue : le score du fils (0) n'a aucun sens, ne pas
+    // l'utiliser ni le stocker dans la table partagée
+    if (SEARCH_STOPPED())
+      return 0;
+
 #ifdef DEBUG
     DEBUG_LOG("[NEGAMAX] ply=%d move=%s score=%d color=%s\n", ply,
-              move_to_string(&ordered_moves.moves[i]), score,
+              move_to_string(&move), score,
               color == WHITE ? "WHITE" : "BLACK");
 #endif
 
     if (score > max_score) {
       max_score = score;
-      best_move = ordered_moves.moves[i];
+      best_move = move;
     }
 
     if (max_score > alpha) {
       alpha = max_score;
+      if (is_pv_node)
+        update_pv(ply, best_move);
     }
 
     if (alpha >= beta) {
@@ -353,7 +512,8 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
       }
 #endif
 #if VERSION >= 3
-      tt_store(&tt_global, hash, depth, beta, TT_LOWERBOUND, best_move, ply);
+      tt_store(&tt_global, hash, depth, beta, TT_LOWERBOUND, best_move,
+               static_eval, is_pv_node, ply);
 #endif
 #ifdef DEBUG
       DEBUG_LOG("[NEGAMAX] ply=%d beta cutoff move=%s score=%d\n", ply,
@@ -363,6 +523,14 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
     }
   }
 
+  if (move_count == 0) {
+    if (is_in_check(board, color)) {
+      return -MATE_SCORE + ply; // Mat
+    } else {
+      return STALEMATE_SCORE; // Pat
+    }
+  }
+
 #if VERSION >= 3
   // V3: Transposition Table Store
   TTEntryType tt_type;
@@ -373,7 +541,8 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
   } else {
     tt_type = TT_EXACT;
   }
-  tt_store(&tt_global, hash, depth, max_score, tt_type, best_move, ply);
+  tt_store(&tt_global, hash, depth, max_score, tt_type, best_move, static_eval,
+           is_pv_node, ply);
 #endif
 
   return max_score;
@@ -381,106 +550,487 @@ int negamax_alpha_beta(Board *board, int depth, int alpha, int beta,
 
 // ========== RECHERCHE ITÉRATIVE (Iterative Deepening) ==========
 
-SearchResult search_iterative_deepening(Board *board, int max_depth,
-                                        int time_limit_ms) {
-  search_start_time = clock();
-  search_time_limit_ms = time_limit_ms;
-  search_should_stop = 0;
-  global_nodes_searched = 0; // Reset global counter
+// Lazy SMP : les helpers sautent certaines profondeurs (décalage par thread)
+// pour ne pas tous chercher la même itération au même moment
+static int skip_iteration(int thread_id, int depth) {
+  static const int skip_size[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                    3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+  static const int skip_phase[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                                     4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+  if (thread_id == 0)
+    return 0;
+  int i = (thread_id - 1) % 20;
+  return ((depth + skip_phase[i]) / skip_size[i]) % 2;
+}
 
+// Prolonge une variation principale tronquée (coupure par la TT dans un
+// noeud PV) avec les coups de la table de transposition, tant qu'ils sont
+// légaux et sans repasser par une position déjà vue
+static void extend_pv_from_tt(const Board *root, Move *pv, int *length) {
 #if VERSION >= 3
-  tt_new_search(&tt_global); // V3
+  Board board = *root;
+  uint64_t seen[PV_MAX_LENGTH + 1];
+  UndoInfo undo;
+
+  seen[0] = board.zobrist_key;
+  for (int i = 0; i < *length; i++) {
+    make_move(&board, &pv[i], &undo);
+    seen[i + 1] = board.zobrist_key;
+  }
+
+  while (*length < PV_MAX_LENGTH) {
+    TTData tt_data;
+    if (!tt_probe(&tt_global, board.zobrist_key, 0, &tt_data) ||
+        tt_data.best_move == MOVE_NONE)
+      break;
+
+    MoveList moves;
+    generate_legal_moves(&board, &moves);
+    int legal = 0;
+    for (int i = 0; i < moves.count && !legal; i++)
+      legal = (moves.moves[i] == tt_data.best_move);
+    if (!legal)
+      break;
+
+    make_move(&board, &tt_data.best_move, &undo);
+    int repeated = 0;
+    for (int i = 0; i <= *length && !repeated; i++)
+      repeated = (seen[i] == board.zobrist_key);
+    if (repeated)
+      break;
+
+    pv[(*length)++] = tt_data.best_move;
+    seen[*length] = board.zobrist_key;
+  }
+#else
+  (void)root;
+  (void)pv;
+  (void)length;
 #endif
+}
 
-  SearchResult best_result = {0};
-  best_result.score = -INFINITY_SCORE;
-  best_result.nodes_searched = 0;
+// Recherche des coups de la racine dans la fenêtre [alpha, beta] : premier
+// coup en fenêtre complète, les suivants en fenêtre nulle re-cherchés s'ils
+// battent alpha (PVS). Retourne le meilleur score, du point de vue du camp
+// au trait (<= alpha ou >= beta si la fenêtre a échoué)
+static int search_root(Board *board, const OrderedMoveList *ordered_moves,
+                       int depth, int alpha, int beta, Move *best_move,
+                       uint64_t *best_move_nodes) {
+  int best_score = -INFINITY_SCORE;
+  *best_move = ordered_moves->count > 0 ? ordered_moves->moves[0] : MOVE_NONE;
+  *best_move_nodes = 0;
+  pv_length[0] = 0;
+
+  for (int i = 0; i < ordered_moves->count; i++) {
+    Move move = ordered_moves->moves[i];
+    uint64_t move_start_nodes = thread_nodes_searched;
+
+    // Coup en cours (thread principal), seulement passé CURRMOVE_DELAY_MS :
+    // les recherches courtes n'écrivent rien de plus sur stdout
+    if (!search_silent && current_thread != NULL && current_thread->id == 0 &&
+        search_elapsed_ms() >= CURRMOVE_DELAY_MS) {
+      printf("info depth %d currmove %s currmovenumber %d\n", depth,
+             move_to_string(&move), i + 1);
+      fflush(stdout);
+    }
 
-  // ========== FIX #2: INITIALISATION SÉCURISÉE ==========
-  Move best_move_overall;
-  best_move_overall.from = -1; // ✅ Marqueur invalide
-  best_move_overall.to = -1;
-  int best_score_overall = -INFINITY_SCORE;
+    apply_move(board, &move, 0);
 
-  for (int current_depth = 1; current_depth <= max_depth; current_depth++) {
-    MoveList moves;
-    generate_legal_moves(board, &moves);
-    if (moves.count == 0)
+    // negamax retourne l'évaluation du point de vue du camp qui joue après
+    // le coup, on prend le négatif pour le joueur racine
+    Couleur opponent = board->to_move;
+    int score;
+#if VERSION >= 4
+    if (i == 0) {
+      score = -negamax_alpha_beta(board, depth - 1, -beta, -alpha, opponent,
+                                  1, 0);
+    } else {
+      score = -negamax_alpha_beta(board, depth - 1, -alpha - 1, -alpha,
+                                  opponent, 1, 0);
+      if (score > alpha && score < beta) {
+        score = -negamax_alpha_beta(board, depth - 1, -beta, -alpha,
+                                    opponent, 1, 0);
+      }
+    }
+#else
+    score =
+        -negamax_alpha_beta(board, depth - 1, -beta, -alpha, opponent, 1, 0);
+#endif
+
+    undo_move(board, 0);
+
+    if (SEARCH_STOPPED())
       break;
 
-    OrderedMoveList ordered_moves;
-    order_moves(board, &moves, &ordered_moves, (Move){0}, 0);
+    if (score > best_score) {
+      best_score = score;
+      *best_move = move;
+      *best_move_nodes = thread_nodes_searched - move_start_nodes;
+      update_pv(0, move); // Ligne du coup, dans pv_table[0]
+    }
+    if (score > alpha)
+      alpha = score;
+    if (alpha >= beta)
+      break; // Échec haut : la fenêtre sera élargie
+  }
 
-    Move best_move_this_iter = ordered_moves.moves[0];
-    int best_score_this_iter = -INFINITY_SCORE;
+  return best_score;
+}
 
-    // ✅ Sauvegarder le joueur à la racine
-    Couleur root_player = board->to_move;
+// Recherche d'une ligne de la racine parmi les coups candidats, dans une
+// fenêtre d'aspiration centrée sur le score de la même ligne à l'itération
+// précédente (prev, NULL si aucune). Remplit line (partielle si la recherche
+// est arrêtée) ; *effort_pct reçoit la part des noeuds de la passe finale
+// passée sur le meilleur coup
+static void search_root_line(Board *board, const MoveList *candidates,
+                             int depth, const RootLine *prev, RootLine *line,
+                             int *effort_pct) {
+  // Fenêtre d'aspiration centrée sur le score de l'itération précédente
+  int alpha = -INFINITY_SCORE;
+  int beta = INFINITY_SCORE;
+  int delta = ASPIRATION_WINDOW;
+#if VERSION >= 4
+  if (prev != NULL && depth >= ASPIRATION_MIN_DEPTH &&
+      abs(prev->score) < MATE_SCORE - 100) {
+    alpha = prev->score - delta;
+    beta = prev->score + delta;
+  }
+#endif
 
-    for (int i = 0; i < ordered_moves.count; i++) {
-      apply_move(board, &ordered_moves.moves[i], 0);
+  // Coup joué en premier : meilleur coup de l'itération précédente, puis
+  // celui qui a dépassé beta lors d'une re-recherche
+  Move root_first_move = prev != NULL ? prev->move : MOVE_NONE;
+  uint64_t pass_start_nodes, best_move_nodes;
 
-      // La couleur à passer à negamax doit être la couleur qui est maintenant
-      // à jouer après avoir appliqué le coup (board->to_move).
-      Couleur color_for_negamax = board->to_move;
+  for (;;) {
+    OrderedMoveList ordered_moves;
+    order_moves(board, (MoveList *)candidates, &ordered_moves,
+                root_first_move, 0);
 
-      // negamax retourne l'évaluation du point de vue de color_for_negamax,
-      // on prend ensuite le négatif pour obtenir l'évaluation du joueur racine.
-      int score = -negamax_alpha_beta(board, current_depth - 1, -INFINITY_SCORE,
-                                      INFINITY_SCORE, color_for_negamax, 1, 0);
+    pass_start_nodes = thread_nodes_searched;
+    line->score = search_root(board, &ordered_moves, depth, alpha, beta,
+                              &line->move, &best_move_nodes);
+    if (SEARCH_STOPPED())
+      break;
 
 #ifdef DEBUG
-      DEBUG_LOG("[ITERATIVE] depth=%d move=%s score=%d root_player=%s\n",
-                current_depth, move_to_string(&ordered_moves.moves[i]), score,
-                root_player == WHITE ? "WHITE" : "BLACK");
+    DEBUG_LOG("[ITERATIVE] thread=%d depth=%d window=[%d,%d] best=%s "
+              "score=%d\n",
+              current_thread ? current_thread->id : 0, depth, alpha, beta,
+              move_to_string(&line->move), line->score);
 #endif
 
-      undo_move(board, 0);
+    // Score hors de la fenêtre : l'élargir du côté de l'échec et
+    // recommencer (fenêtre complète au-delà de ASPIRATION_MAX_WINDOW)
+    if (line->score <= alpha && alpha > -INFINITY_SCORE) {
+      alpha = line->score - delta;
+    } else if (line->score >= beta && beta < INFINITY_SCORE) {
+      beta = line->score + delta;
+      root_first_move = line->move;
+    } else {
+      break;
+    }
+    delta *= 2;
+    if (delta > ASPIRATION_MAX_WINDOW || alpha < -INFINITY_SCORE)
+      alpha = -INFINITY_SCORE;
+    if (delta > ASPIRATION_MAX_WINDOW || beta > INFINITY_SCORE)
+      beta = INFINITY_SCORE;
+  }
+
+  // Variation principale de la ligne (pv_table[0] sera réécrite par la
+  // suivante)
+  line->pv_length = pv_length[0];
+  for (int i = 0; i < pv_length[0]; i++)
+    line->pv[i] = pv_table[0][i];
+  if (line->pv_length == 0 && line->move != MOVE_NONE) {
+    line->pv[0] = line->move;
+    line->pv_length = 1;
+  }
 
-      if (search_should_stop)
+  uint64_t pass_nodes = thread_nodes_searched - pass_start_nodes;
+  *effort_pct = pass_nodes > 0 ? (int)(best_move_nodes * 100 / pass_nodes) : 0;
+}
+
+// Score d'une ligne info : " score cp X" ou " score mate N" (N en coups,
+// négatif si le camp au trait est maté). Comme l'exige UCI, le score est du
+// point de vue du camp au trait à la racine (celui du moteur)
+static void print_uci_score(int score) {
+  if (abs(score) >= MATE_SCORE - PV_MAX_LENGTH) {
+    int moves = score > 0 ? (MATE_SCORE - score + 1) / 2
+                          : -(MATE_SCORE + score) / 2;
+    printf(" score mate %d", moves);
+  } else {
+    printf(" score cp %d", score);
+  }
+}
+
+// Ne garde que les coups de la racine listés par searchmoves
+static void restrict_root_moves(MoveList *moves) {
+  int count = 0;
+  for (int i = 0; i < moves->count; i++) {
+    for (int j = 0; j < search_limits.searchmoves_count; j++) {
+      if (moves->moves[i] == search_limits.searchmoves[j]) {
+        moves->moves[count++] = moves->moves[i];
         break;
+      }
+    }
+  }
+  moves->count = count;
+}
+
+// Boucle d'approfondissement d'un thread sur sa propre copie du plateau.
+// Seul le thread principal (id 0) envoie les lignes info et cherche
+// plusieurs lignes en MultiPV (les helpers n'en cherchent qu'une)
+static void iterative_deepening(SearchThread *thread) {
+  Board *board = &thread->board;
+  int is_main = (thread->id == 0);
+
+  current_thread = thread;
+  set_ordering_tables(&thread->ordering);
+  thread_nodes_searched = 0;
+  time_check_countdown = TIME_CHECK_NODES;
+  search_can_stop = 0; // Jusqu'à la fin de la première itération
+
+  // ========== FIX #2: INITIALISATION SÉCURISÉE ==========
+  Move best_move_overall = MOVE_NONE; // ✅ Marqueur invalide
+  int best_score_overall = -INFINITY_SCORE;
 
-      if (score > best_score_this_iter) {
-        best_score_this_iter = score;
-        best_move_this_iter = ordered_moves.moves[i];
+  // Lignes de la racine, triées par score à chaque itération complète
+  // (valid_lines : nombre de lignes de la dernière itération complète)
+  RootLine helper_line;
+  RootLine *lines = is_main ? multipv_lines : &helper_line;
+  int valid_lines = 0;
+
+  // Gestion dynamique du temps (thread principal) : itérations complètes
+  // consécutives avec le même meilleur coup
+  int stable_iterations = 0;
+
+  for (int current_depth = 1; current_depth <= thread->max_depth;
+       current_depth++) {
+    if (skip_iteration(thread->id, current_depth))
+      continue;
+
+    MoveList moves;
+    generate_legal_moves(board, &moves);
+    if (search_limits.searchmoves_count > 0)
+      restrict_root_moves(&moves);
+    if (moves.count == 0)
+      break;
+
+    search_seldepth = 0;
+    int line_count = is_main ? search_multipv : 1;
+    if (line_count > moves.count)
+      line_count = moves.count;
+
+    // Chaque ligne cherche les coups que les précédentes n'ont pas retenus
+    // (la table de transposition est partagée entre les lignes)
+    int effort_pct = 0;
+    for (int k = 0; k < line_count; k++) {
+      const MoveList *candidates = &moves;
+      MoveList remaining;
+      if (k > 0) {
+        remaining.count = 0;
+        for (int i = 0; i < moves.count; i++) {
+          int excluded = 0;
+          for (int j = 0; j < k && !excluded; j++)
+            excluded = (moves.moves[i] == lines[j].move);
+          if (!excluded)
+            remaining.moves[remaining.count++] = moves.moves[i];
+        }
+        candidates = &remaining;
       }
+
+      int line_effort_pct;
+      search_root_line(board, candidates, current_depth,
+                       k < valid_lines ? &lines[k] : NULL, &lines[k],
+                       &line_effort_pct);
+      if (SEARCH_STOPPED())
+        break;
+      if (k == 0)
+        effort_pct = line_effort_pct;
     }
 
-    if (search_should_stop && best_move_overall.from == -1) {
-      best_move_overall = best_move_this_iter;
-      best_score_overall = best_score_this_iter;
+    if (SEARCH_STOPPED() && best_move_overall == MOVE_NONE) {
+      best_move_overall = lines[0].move;
+      best_score_overall = lines[0].score;
+      thread->pv[0] = best_move_overall;
+      thread->pv_length = (best_move_overall != MOVE_NONE);
       break;
-    } else if (search_should_stop) {
+    } else if (SEARCH_STOPPED()) {
       break;
     }
 
-    best_move_overall = best_move_this_iter;
-    best_score_overall = best_score_this_iter;
-    best_result.nodes_searched = global_nodes_searched; // Use global counter
+    // Tri stable des lignes par score (une ligne suivante peut dépasser la
+    // précédente, la recherche n'étant pas parfaitement monotone)
+    for (int k = 1; k < line_count; k++) {
+      RootLine line = lines[k];
+      int j = k;
+      while (j > 0 && lines[j - 1].score < line.score) {
+        lines[j] = lines[j - 1];
+        j--;
+      }
+      lines[j] = line;
+    }
+    valid_lines = line_count;
+
+    int score_drop = best_move_overall == MOVE_NONE
+                         ? 0
+                         : best_score_overall - lines[0].score;
+    stable_iterations = (lines[0].move == best_move_overall)
+                            ? stable_iterations + 1
+                            : 0;
+
+    best_move_overall = lines[0].move;
+    best_score_overall = lines[0].score;
+    thread->completed_depth = current_depth;
+    search_can_stop = 1;
+
+    // Variations principales complétées par la TT
+    for (int k = 0; k < line_count; k++)
+      extend_pv_from_tt(board, lines[k].pv, &lines[k].pv_length);
+    thread->pv_length = lines[0].pv_length;
+    for (int i = 0; i < lines[0].pv_length; i++)
+      thread->pv[i] = lines[0].pv[i];
+
+    if (is_main && !search_silent) {
+      uint64_t nodes = total_nodes_searched();
+      int elapsed_ms = search_elapsed_ms();
+      if (elapsed_ms == 0)
+        elapsed_ms = 1;
+      uint64_t nps = nodes * 1000 / (uint64_t)elapsed_ms;
+#if VERSION >= 3
+      int hashfull = tt_hashfull(&tt_global);
+#else
+      int hashfull = 0;
+#endif
 
-    clock_t end_time = clock();
-    int elapsed_ms =
-        (int)(((double)(end_time - search_start_time)) / CLOCKS_PER_SEC * 1000);
-    if (elapsed_ms == 0)
-      elapsed_ms = 1;
-    int nps = (int)(best_result.nodes_searched * 1000 / elapsed_ms);
+      for (int k = 0; k < line_count; k++) {
+        printf("info depth %d seldepth %d", current_depth,
+               search_seldepth > current_depth ? search_seldepth
+                                                : current_depth);
+        if (search_multipv > 1)
+          printf(" multipv %d", k + 1);
+        print_uci_score(lines[k].score);
+        printf(" nodes %" PRIu64 " nps %" PRIu64 " hashfull %d time %d pv",
+               nodes, nps, hashfull, elapsed_ms);
+        for (int i = 0; i < lines[k].pv_length; i++)
+          printf(" %s", move_to_string(&lines[k].pv[i]));
+        printf("\n");
+      }
+      fflush(stdout);
+    }
 
-    // ✅ Normalisation du score pour UCI (toujours du point de vue BLANC)
-    best_result.score =
-        (root_player == WHITE) ? best_score_overall : -best_score_overall;
+    // Mat trouvé : inutile d'approfondir. Avec go mate N, seul un mat en N
+    // coups au plus (2N-1 plies) arrête la recherche
+    if (search_limits.mate > 0) {
+      if (best_score_overall >= MATE_SCORE - (2 * search_limits.mate - 1))
+        break;
+    } else if (abs(best_score_overall) >= MATE_SCORE - 100) {
+      break;
+    }
 
-    printf("info depth %d score cp %d nodes %d nps %d time %d pv %s\n",
-           current_depth, best_result.score, best_result.nodes_searched, nps,
-           elapsed_ms, move_to_string(&best_move_overall));
-    fflush(stdout);
+    // Limite souple, ajustée selon la stabilité du meilleur coup, la baisse
+    // du score et la part des noeuds de la racine passée sur ce coup : pas de
+    // nouvelle itération (les helpers s'arrêtent avec le thread principal)
+    if (is_main) {
+      int optimum_ms = scale_optimum_time(&search_limits.time, stable_iterations,
+                                          score_drop, effort_pct);
+      if (time_limit_reached(optimum_ms)) {
+        search_request_stop();
+        break;
+      }
+    }
+  }
 
-    if (abs(best_score_overall) >= MATE_SCORE - 100) {
-      break;
+  thread->best_move = best_move_overall;
+  thread->best_score = best_score_overall;
+  atomic_store_explicit(&thread->nodes, thread_nodes_searched,
+                        memory_order_relaxed);
+}
+
+static void *search_worker(void *arg) {
+  iterative_deepening((SearchThread *)arg);
+  return NULL;
+}
+
+SearchResult search_iterative_deepening(Board *board, int max_depth,
+                                        const SearchLimits *limits) {
+  long start_ms = get_time_ms();
+  atomic_store_explicit(&search_start_time_ms, start_ms, memory_order_relaxed);
+  atomic_store_explicit(&search_clock_start_ms, start_ms,
+                        memory_order_relaxed);
+  if (limits != NULL)
+    search_limits = *limits;
+  else
+    memset(&search_limits, 0, sizeof(search_limits));
+
+#if VERSION >= 3
+  if (tt_global.clusters == NULL) {
+    tt_resize(&tt_global, TT_DEFAULT_SIZE_MB); // Aucune option Hash reçue
+  }
+  tt_new_search(&tt_global); // V3
+#endif
+
+  // Chaque thread cherche la même racine sur sa copie du plateau ; seule la
+  // table de transposition est partagée (Lazy SMP)
+  for (int i = 0; i < search_thread_count; i++) {
+    SearchThread *thread = &search_threads[i];
+    thread->id = i;
+    thread->board = *board;
+    thread->max_depth = max_depth;
+    thread->completed_depth = 0;
+    thread->best_move = MOVE_NONE;
+    thread->best_score = -INFINITY_SCORE;
+    thread->pv_length = 0;
+    thread->started = 0;
+    atomic_store_explicit(&thread->nodes, 0, memory_order_relaxed);
+  }
+  for (int i = 1; i < search_thread_count; i++) {
+    SearchThread *thread = &search_threads[i];
+    thread->started =
+        (pthread_create(&thread->handle, NULL, search_worker, thread) == 0);
+    if (!thread->started) {
+      DEBUG_LOG("[SMP] Échec de création du thread %d\n", i);
     }
   }
 
+  // Le thread appelant est le thread principal
+  iterative_deepening(&search_threads[0]);
+
+  // Profondeur atteinte (ou temps écoulé) : arrêter les helpers
+  search_request_stop();
+
+#ifdef DEBUG
+  // Dépassement de la limite dure (latence de l'arrêt, charge machine)
+  if (search_limits.time.hard_ms > 0 &&
+      search_clock_elapsed_ms() > search_limits.time.hard_ms)
+    DEBUG_LOG("[TIME] Dépassement de %d ms (limite dure %d ms)\n",
+              search_clock_elapsed_ms() - search_limits.time.hard_ms,
+              search_limits.time.hard_ms);
+#endif
+  for (int i = 1; i < search_thread_count; i++) {
+    if (search_threads[i].started)
+      pthread_join(search_threads[i].handle, NULL);
+  }
+
+  // Coup du thread ayant terminé l'itération la plus profonde (le thread
+  // principal à égalité, et toujours en MultiPV : ses lignes ont été
+  // annoncées)
+  SearchThread *best_thread = &search_threads[0];
+  uint64_t total_nodes = 0;
+  for (int i = 0; i < search_thread_count; i++) {
+    SearchThread *thread = &search_threads[i];
+    total_nodes += atomic_load_explicit(&thread->nodes, memory_order_relaxed);
+    if (search_multipv == 1 && thread->best_move != MOVE_NONE &&
+        thread->completed_depth > best_thread->completed_depth)
+      best_thread = thread;
+  }
+
+  Move best_move_overall = best_thread->best_move;
+  int best_score_overall = best_thread->best_score;
+
   // ✅ Vérification finale : coup valide ?
-  if (best_move_overall.from == -1 || best_move_overall.to == -1) {
+  if (best_move_overall == MOVE_NONE) {
     // Fallback d'urgence : prendre le premier coup légal
     MoveList emergency_moves;
     generate_legal_moves(board, &emergency_moves);
@@ -491,15 +1041,31 @@ SearchResult search_iterative_deepening(Board *board, int max_depth,
     }
   }
 
+  SearchResult best_result = {0};
   best_result.best_move = best_move_overall;
-  // On conserve la normalisation du score pour UCI
-  // best_result.score déjà mis à jour dans la boucle
-  best_result.depth = max_depth;
+  // Réponse attendue : second coup de la variation principale
+  best_result.ponder_move =
+      (best_thread->best_move == best_move_overall && best_thread->pv_length > 1)
+          ? best_thread->pv[1]
+          : MOVE_NONE;
+  // ✅ Normalisation du score pour UCI (toujours du point de vue BLANC)
+  best_result.score =
+      (board->to_move == WHITE) ? best_score_overall : -best_score_overall;
+  best_result.nodes = total_nodes;
+  best_result.nodes_searched = total_nodes;
+  int elapsed_ms = search_elapsed_ms();
+  if (elapsed_ms == 0)
+    elapsed_ms = 1;
+  best_result.nps = total_nodes * 1000 / (uint64_t)elapsed_ms;
+  // Dernière itération complète (pas max_depth : nodes, mate ou le temps
+  // peuvent arrêter la recherche avant)
+  best_result.depth = best_thread->completed_depth;
 
   return best_result;
 }
 
 // Wrapper pour l'ancienne API
 SearchResult search_best_move(Board *board, int depth) {
-  return search_iterative_deepening(board, depth, 0);
-}
\ No newline at end of file
+  search_reset_stop();
+  return search_iterative_deepening(board, depth, NULL);
+}
@@ -1,12 +1,14 @@
 #ifndef SEARCH_H
 #define SEARCH_H
 
+#include "attacks.h"
 #include "board.h"
 #include "evaluation.h"
 #include "move_ordering.h"
 #include "movegen.h"
 #include "quiescence.h"
 #include "search_helpers.h"
+#include "timemanager.h"
 #include "transposition.h"
 #include "utils.h"
 #include "zobrist.h"
@@ -15,26 +17,68 @@
 // Structure pour le résultat de la recherche
 typedef struct {
   Move best_move;     // Meilleur coup trouvé
-  int depth;          // Profondeur atteinte
-  int score;          // Score de la position (en centipawns)
-  int nodes;          // Nombre de nœuds explorés
-  int nps;            // Nœuds par seconde
-  int nodes_searched; // Nombre de nœuds explorés (alias)
+  Move ponder_move;   // Réponse attendue (MOVE_NONE si inconnue)
+  int depth;               // Profondeur atteinte
+  int score;               // Score de la position (en centipawns)
+  uint64_t nodes;          // Nombre de nœuds explorés (tous threads)
+  uint64_t nps;            // Nœuds par seconde
+  uint64_t nodes_searched; // Nombre de nœuds explorés (alias)
 } SearchResult;
 
+// Limites d'une recherche (0 : pas de limite). Elles se combinent : la
+// première atteinte arrête la recherche
+typedef struct {
+  TimeLimits time;
+  uint64_t nodes; // Budget de noeuds, tous threads confondus
+  int mate;   // Arrêt dès qu'un mat en mate coups au plus est trouvé
+  Move searchmoves[256]; // Coups de la racine autorisés (searchmoves)
+  int searchmoves_count; // 0 : tous les coups légaux
+} SearchLimits;
+
+// Nombre maximal de threads de recherche (option UCI Threads)
+#define SEARCH_MAX_THREADS 256
+
+// Nombre maximal de lignes annoncées (option UCI MultiPV)
+#define SEARCH_MAX_MULTIPV 256
+
 // ========== FONCTIONS PRINCIPALES ==========
 
-// Interface principale de recherche
+// Interface principale de recherche (limits NULL : pas de limite).
+// Le drapeau d'arrêt n'est pas remis à zéro par la recherche : l'appelant
+// le fait avant (search_reset_stop) pour qu'un stop reçu pendant le
+// lancement ne soit pas perdu
 SearchResult search_best_move(Board *board, int depth);
 SearchResult search_iterative_deepening(Board *board, int max_depth,
-                                        int time_limit_ms);
+                                        const SearchLimits *limits);
+
+// Arrêt de la recherche (utilisable depuis un autre thread)
+void search_reset_stop(void);
+void search_request_stop(void);
 
-// Initialisation du moteur
+// Pondering : avant le lancement, search_set_ponder(1) suspend la limite de
+// temps ; search_ponderhit() la réactive pendant la recherche, à partir de
+// maintenant, sans la relancer
+void search_set_ponder(int pondering);
+void search_ponderhit(void);
+
+// Initialisation du moteur (vide aussi la table de transposition)
 void initialize_engine(void);
 
-// Fonction utilitaire pour envoyer des infos UCI pendant la recherche
-void send_search_info(int depth, int score, int nodes, int nps,
-                      const Move *pv_move);
+// Nombre de threads de la prochaine recherche (Lazy SMP : tous cherchent la
+// même racine et partagent la table de transposition), retourne la valeur
+// retenue
+int search_set_threads(int count);
+
+// Nombre de lignes de la racine cherchées et annoncées à chaque itération
+// (info multipv k), retourne la valeur retenue
+int search_set_multipv(int count);
+
+// Supprime les lignes info pendant les recherches suivantes (bench)
+void search_set_silent(int silent);
+
+// Réalloue la table de transposition (option UCI Hash), retourne la taille
+// obtenue en MB
+size_t search_set_hash_size(size_t size_mb);
 
 // ========== NEGAMAX ==========
 
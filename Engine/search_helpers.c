@@ -9,9 +9,18 @@
 #define DEBUG_LOG(...)
 #endif
 
+// ========== ARRÊT DE LA RECHERCHE ==========
+
+atomic_int search_should_stop;
+_Thread_local int search_can_stop;
+_Thread_local int search_seldepth;
+
 // ========== BACKUP STACK ==========
 
-static Board search_backup_stack[128]; // Stack pour sauvegardes (par ply)
+// Par ply : le coup joué et ce qu'il faut pour l'annuler (quelques octets
+// au lieu d'une copie complète du Board). Une pile par thread de recherche
+static _Thread_local Move search_move_stack[128];
+static _Thread_local UndoInfo search_undo_stack[128];
 
 // ========== TABLE LMR ==========
 
@@ -20,15 +29,13 @@ static int lmr_reductions[64][64]; // [depth][move_number]
 // ========== GESTION DES COUPS ==========
 
 void apply_move(Board *board, const Move *move, int ply) {
-  // Sauvegarder l'état AVANT modification
-  search_backup_stack[ply] = *board;
-
-  // Appliquer le mouvement
-  Board dummy_backup; // Non utilisé dans make_move_temp
-  make_move_temp(board, move, &dummy_backup);
+  search_move_stack[ply] = *move;
+  make_move(board, move, &search_undo_stack[ply]);
 }
 
-void undo_move(Board *board, int ply) { *board = search_backup_stack[ply]; }
+void undo_move(Board *board, int ply) {
+  unmake_move(board, &search_move_stack[ply], &search_undo_stack[ply]);
+}
 
 // ========== HELPERS DE RECHERCHE ==========
 
@@ -37,8 +44,7 @@ int is_quiet_move(const Move *move) {
   // - Une capture
   // - Une promotion
   // - Un en-passant (type spécial de capture)
-  return (move->type != MOVE_CAPTURE && move->type != MOVE_PROMOTION &&
-          move->type != MOVE_EN_PASSANT);
+  return !MOVE_IS_CAPTURE(*move) && !MOVE_IS_PROMOTION(*move);
 }
 
 // ========== LMR ==========
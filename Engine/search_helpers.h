@@ -3,12 +3,37 @@
 
 #include "board.h"
 #include "movegen.h"
+#include <stdatomic.h>
 
 // Scores spéciaux pour la recherche
 #define MATE_SCORE 30000
 #define STALEMATE_SCORE 0
 #define INFINITY_SCORE 50000
 
+// ========== ARRÊT DE LA RECHERCHE ==========
+
+// Drapeau d'arrêt partagé par tous les threads de recherche : levé par la
+// limite de temps ou par l'interface (stop, quit), lu par negamax et la
+// quiescence
+extern atomic_int search_should_stop;
+
+// Propre à chaque thread : l'arrêt n'est pris en compte qu'une fois la
+// première itération terminée (bestmove vient toujours d'une vraie recherche)
+extern _Thread_local int search_can_stop;
+
+#define SEARCH_STOPPED()                                                       \
+  (search_can_stop &&                                                          \
+   atomic_load_explicit(&search_should_stop, memory_order_relaxed))
+
+// Compte un noeud (negamax ou quiescence) pour le thread courant et, tous
+// les TIME_CHECK_NODES noeuds, vérifie les limites de temps et de noeuds
+// (défini dans search.c, avec les compteurs de la recherche)
+void search_count_node(void);
+
+// Profondeur sélective du thread : ply le plus profond atteint par negamax
+// ou la quiescence depuis le début de l'itération (seldepth)
+extern _Thread_local int search_seldepth;
+
 // ========== GESTION DES COUPS ==========
 
 // Applique temporairement un mouvement avec sauvegarde
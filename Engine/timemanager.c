@@ -13,12 +13,13 @@
 // Constantes pour la gestion du temps
 #define DEFAULT_TIME_MS 3000
 #define MIN_TIME_MS 50
-#define PANIC_THRESHOLD_MS 1000
-#define PANIC_TIME_DIVISOR 5
-#define PANIC_MIN_TIME_MS 10
-#define SAFETY_BUFFER_MS 50
-#define MAX_TIME_PER_MOVE_MS 5000
+#define MAX_MOVES_TO_GO 50
+#define INC_USED_PCT 75      // Part de l'incrément dépensée à chaque coup
 #define MAX_TIME_FRACTION 10 // Utiliser max 1/10 du temps restant
+#define HARD_LIMIT_FACTOR 5    // Limite dure = 5x la limite souple...
+#define HARD_LIMIT_FRACTION 4  // ...sans dépasser 1/4 du temps restant
+#define RESERVE_FRACTION 10    // Toujours garder 1/10 du temps en réserve
+#define SCORE_DROP_MAX_CP 100  // Baisse de score donnant la prolongation max
 
 // Parse les paramètres de la commande "go"
 void parse_go_params(char *params, GoParams *go_params) {
@@ -34,6 +35,7 @@ void parse_go_params(char *params, GoParams *go_params) {
   go_params->movetime = -1;
   go_params->infinite = 0;
   go_params->ponder = 0;
+  go_params->searchmoves_count = 0;
 
   DEBUG_LOG_TIME("Parsing go params: '%s'\n", params ? params : "(null)");
 
@@ -69,7 +71,7 @@ void parse_go_params(char *params, GoParams *go_params) {
     } else if (strcmp(token, "nodes") == 0) {
       token = strtok(NULL, " ");
       if (token)
-        go_params->nodes = atoi(token);
+        go_params->nodes = atoll(token);
     } else if (strcmp(token, "mate") == 0) {
       token = strtok(NULL, " ");
       if (token)
@@ -80,13 +82,17 @@ void parse_go_params(char *params, GoParams *go_params) {
         go_params->movetime = atoi(token);
     } else if (strcmp(token, "infinite") == 0) {
       go_params->infinite = 1;
+      token = strtok(NULL, " ");
+      continue; // Mot-clé sans valeur
     } else if (strcmp(token, "ponder") == 0) {
       go_params->ponder = 1;
+      token = strtok(NULL, " ");
+      continue; // Mot-clé sans valeur
     } else if (strcmp(token, "searchmoves") == 0) {
-      // Ignorer proprement searchmoves (liste de coups à considérer)
+      // Liste de coups à considérer à la racine
       // Format: searchmoves e2e4 d2d4 ...
-      // On saute tous les tokens jusqu'à un autre keyword
-      DEBUG_LOG_TIME("searchmoves parameter ignored\n");
+      // On lit tous les tokens jusqu'à un autre keyword (les coups sont
+      // vérifiés contre la position par handle_go)
       token = strtok(NULL, " ");
       while (token != NULL) {
         // Vérifier si c'est un keyword connu
@@ -99,6 +105,11 @@ void parse_go_params(char *params, GoParams *go_params) {
           // Revenir en arrière pour retraiter ce token
           break;
         }
+        if (go_params->searchmoves_count < 256) {
+          char *move = go_params->searchmoves[go_params->searchmoves_count++];
+          strncpy(move, token, 5);
+          move[5] = '\0';
+        }
         token = strtok(NULL, " ");
       }
       continue; // Retraiter le token courant
@@ -124,16 +135,16 @@ int estimate_moves_to_go(const Board *board) {
   }
 }
 
-// Calcule le temps alloué pour ce coup
+// Calcule le temps optimal pour ce coup (part moyenne du temps restant),
+// ajusté ensuite à chaque itération par scale_optimum_time
 int calculate_time_for_move(const Board *board, const GoParams *params) {
   DEBUG_LOG_TIME("Calculating time for move (to_move=%s)\n",
                  board->to_move == WHITE ? "WHITE" : "BLACK");
 
   // Cas 1: Temps fixe spécifié
   if (params->movetime > 0) {
-    int allocated_time = (int)(params->movetime * 0.95); // 90% du movetime
-    DEBUG_LOG_TIME("Using fixed movetime: %dms, allocated: %dms\n", params->movetime, allocated_time);
-    return allocated_time;
+    DEBUG_LOG_TIME("Using fixed movetime: %dms\n", params->movetime);
+    return params->movetime;
   }
 
   // Cas 2: Mode infini
@@ -154,48 +165,133 @@ int calculate_time_for_move(const Board *board, const GoParams *params) {
     return DEFAULT_TIME_MS;
   }
 
-  // Cas 4: Mode panique (moins d'1 seconde)
-  if (my_time < PANIC_THRESHOLD_MS) {
-    int panic_time = my_time / PANIC_TIME_DIVISOR;
-    if (panic_time < PANIC_MIN_TIME_MS) {
-      panic_time = PANIC_MIN_TIME_MS;
-    }
-    DEBUG_LOG_TIME("Panic mode: %dms\n", panic_time);
-    return panic_time;
-  }
-
-  // Cas 5: Gestion normale du temps
+  // Cas 4: Gestion normale du temps
   int moves_to_go =
       params->movestogo > 0 ? params->movestogo : estimate_moves_to_go(board);
+  if (moves_to_go > MAX_MOVES_TO_GO)
+    moves_to_go = MAX_MOVES_TO_GO;
 
-  // Formule: (temps_restant * 2) / (coups_restants * 3) + incrément
-  // Cela alloue ~2/3 du temps moyen par coup, laissant une marge
-  int allocated_time = (my_time * 2 / (moves_to_go * 3)) + my_inc;
+  // Part moyenne du temps restant, plus l'essentiel de l'incrément. Pas de
+  // plafond absolu : la limite dure (calculate_time_limits) borne le coup
+  // selon le temps restant, et la stabilité de la recherche raccourcit les
+  // coups faciles
+  int allocated_time = my_time / moves_to_go + my_inc * INC_USED_PCT / 100;
 
-  // Sécurité 1: Maximum 1/10 du temps restant + incrément
+  // Sécurité 1: Maximum 1/10 du temps restant + incrément (sauf contrôle
+  // de temps imminent)
   int max_time = (my_time / MAX_TIME_FRACTION) + my_inc;
-  if (allocated_time > max_time) {
+  if (moves_to_go > MAX_TIME_FRACTION && allocated_time > max_time) {
     allocated_time = max_time;
   }
 
-  // Sécurité 2: Minimum pour permettre une recherche décente
+  // Sécurité 2: Minimum pour permettre une recherche décente (borné ensuite
+  // par le temps réellement disponible)
   if (allocated_time < MIN_TIME_MS) {
     allocated_time = MIN_TIME_MS;
   }
 
-  // Sécurité 3: Buffer de sécurité pour éviter les time-outs (5%)
-  int safety_margin = (int)(allocated_time * 0.05);
-  if (allocated_time > safety_margin) {
-    allocated_time -= safety_margin;
+  DEBUG_LOG_TIME("Allocated time: %dms (moves_to_go=%d)\n", allocated_time,
+                 moves_to_go);
+
+  return allocated_time;
+}
+
+// Calcule les limites souple et dure de la recherche
+void calculate_time_limits(const Board *board, const GoParams *params,
+                           int move_overhead_ms, TimeLimits *limits) {
+  limits->soft_ms = 0;
+  limits->hard_ms = 0;
+
+  int my_time = (board->to_move == WHITE) ? params->wtime : params->btime;
+
+  // Recherche infinie, ou profondeur, noeuds ou mat fixés sans pendule :
+  // pas de limite
+  if (params->infinite ||
+      ((params->depth > 0 || params->nodes > 0 || params->mate > 0) &&
+       params->movetime <= 0 && my_time < 0)) {
+    DEBUG_LOG_TIME("No time limit\n");
+    return;
   }
 
-  // Sécurité 4: Maximum absolu pour positions complexes
-  if (allocated_time > MAX_TIME_PER_MOVE_MS) {
-    allocated_time = MAX_TIME_PER_MOVE_MS;
+  // Temps fixe : une seule limite, latence déduite
+  if (params->movetime > 0) {
+    int limit = params->movetime - move_overhead_ms;
+    if (limit < 1)
+      limit = 1;
+    limits->soft_ms = limit;
+    limits->hard_ms = limit;
+    DEBUG_LOG_TIME("Movetime limits: soft=hard=%dms\n", limit);
+    return;
   }
 
-  DEBUG_LOG_TIME("Allocated time: %dms (moves_to_go=%d)\n", allocated_time,
-                 moves_to_go);
+  int soft = calculate_time_for_move(board, params);
+  if (my_time < 0) {
+    // Pas de pendule : temps par défaut, sans prolongation
+    limits->soft_ms = soft;
+    limits->hard_ms = soft;
+    return;
+  }
 
-  return allocated_time;
+  // Jamais plus que le temps réellement disponible (latence déduite)
+  int available = my_time - move_overhead_ms;
+  if (available < 1)
+    available = 1;
+
+  // La limite dure laisse prolonger un coup difficile, dans une fraction
+  // bornée du temps restant (tout le temps disponible si le contrôle de
+  // temps est au prochain coup)
+  int moves_to_go = params->movestogo > 0 ? params->movestogo
+                                          : HARD_LIMIT_FRACTION;
+  if (moves_to_go > HARD_LIMIT_FRACTION)
+    moves_to_go = HARD_LIMIT_FRACTION;
+  int hard = soft * HARD_LIMIT_FACTOR;
+  if (hard > available / moves_to_go)
+    hard = available / moves_to_go;
+  if (hard > available - available / RESERVE_FRACTION)
+    hard = available - available / RESERVE_FRACTION;
+  if (hard < 1)
+    hard = 1;
+  if (soft > hard)
+    soft = hard;
+
+  limits->soft_ms = soft;
+  limits->hard_ms = hard;
+  DEBUG_LOG_TIME("Clock limits: soft=%dms hard=%dms (overhead=%dms)\n", soft,
+                 hard, move_overhead_ms);
+}
+
+// Ajuste la limite souple après une itération complète
+int scale_optimum_time(const TimeLimits *limits, int stable_iterations,
+                       int score_drop, int best_move_effort_pct) {
+  // Temps fixe ou sans pendule (souple = dure) : rien à ajuster
+  if (limits->soft_ms <= 0 || limits->hard_ms <= limits->soft_ms)
+    return limits->soft_ms;
+
+  // Coup instable : prolonger ; stable depuis plusieurs itérations : abréger
+  static const int stability_pct[6] = {150, 125, 105, 90, 80, 70};
+  int stability = stable_iterations < 5 ? stable_iterations : 5;
+
+  // Score en baisse : prolonger jusqu'à +50% (une hausse ne change rien)
+  if (score_drop < 0)
+    score_drop = 0;
+  if (score_drop > SCORE_DROP_MAX_CP)
+    score_drop = SCORE_DROP_MAX_CP;
+  int score_pct = 100 + score_drop * 50 / SCORE_DROP_MAX_CP;
+
+  // Meilleur coup qui absorbe presque tous les noeuds de la racine : les
+  // autres sont réfutés vite, le choix est facile
+  int effort_pct = best_move_effort_pct >= 90   ? 75
+                   : best_move_effort_pct >= 75 ? 90
+                                                : 100;
+
+  long scaled = (long)limits->soft_ms * stability_pct[stability] / 100 *
+                score_pct / 100 * effort_pct / 100;
+  if (scaled > limits->hard_ms)
+    scaled = limits->hard_ms;
+
+  DEBUG_LOG_TIME("Optimum scaled: %dms -> %ldms (stable=%d drop=%d "
+                 "effort=%d%%)\n",
+                 limits->soft_ms, scaled, stable_iterations, score_drop,
+                 best_move_effort_pct);
+  return (int)scaled;
 }
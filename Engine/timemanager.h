@@ -11,19 +11,46 @@ typedef struct {
   int binc;      // Incrément pour les noirs (ms)
   int movestogo; // Nombre de coups avant le prochain contrôle de temps
   int depth;     // Profondeur maximale
-  int nodes;     // Nombre de nœuds maximal à explorer
+  long long nodes; // Nombre de nœuds maximal à explorer (64 bits)
   int mate;      // Chercher un mat en X coups
   int movetime;  // Temps fixe pour ce coup (ms)
   int infinite;  // Recherche infinie
   int ponder;    // Recherche en mode pondering
+  char searchmoves[256][6]; // Coups UCI de "searchmoves" (racine restreinte)
+  int searchmoves_count;
 } GoParams;
 
+// Limites de temps d'une recherche, en ms depuis son début (0 = aucune)
+typedef struct {
+  int soft_ms; // Temps optimal : plus de nouvelle itération au-delà (ajusté
+               // à chaque itération par scale_optimum_time)
+  int hard_ms; // Temps maximal : interrompre la recherche au-delà
+} TimeLimits;
+
+// Option UCI "Move Overhead" : marge retirée du temps disponible pour la
+// latence de communication avec l'interface
+#define DEFAULT_MOVE_OVERHEAD_MS 10
+#define MAX_MOVE_OVERHEAD_MS 5000
+
 // Parse les paramètres de la commande "go"
 void parse_go_params(char *params, GoParams *go_params);
 
-// Calcule le temps alloué pour ce coup
+// Calcule le temps optimal pour ce coup
 int calculate_time_for_move(const Board *board, const GoParams *params);
 
+// Calcule les limites souple et dure de la recherche à partir de la pendule
+// (temps alloué par calculate_time_for_move, moins la marge de latence)
+void calculate_time_limits(const Board *board, const GoParams *params,
+                           int move_overhead_ms, TimeLimits *limits);
+
+// Limite souple ajustée après une itération complète : prolongée si le
+// meilleur coup vient de changer ou si le score baisse (en cp, du point de
+// vue du camp au trait), abrégée s'il est stable depuis plusieurs itérations
+// ou s'il a absorbé l'essentiel des noeuds de la racine. Jamais au-delà de
+// la limite dure ; inchangée pour un temps fixe (souple = dure)
+int scale_optimum_time(const TimeLimits *limits, int stable_iterations,
+                       int score_drop, int best_move_effort_pct);
+
 // Estime le nombre de coups restants selon la phase de jeu
 int estimate_moves_to_go(const Board *board);
 
@@ -1,6 +1,7 @@
 #include "transposition.h"
 #include "evaluation.h" // For MATE_SCORE constant
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // Macro pour logs de debug conditionnels
@@ -10,29 +11,114 @@
 #define DEBUG_LOG(...)
 #endif
 
+_Static_assert(sizeof(TTEntry) == 16, "TTEntry doit tenir sur 16 octets");
+_Static_assert(sizeof(TTCluster) == 64, "TTCluster doit tenir sur 64 octets");
+
+#define CACHE_LINE_SIZE 64
+
+// ========== ENCODAGE ==========
+
+// Accès relaxés : pas de barrière, seulement des lectures/écritures 64 bits
+// indivisibles (la cohérence entre les deux mots vient du XOR)
+#define TT_LOAD(field) atomic_load_explicit(&(field), memory_order_relaxed)
+#define TT_STORE(field, value)                                                 \
+  atomic_store_explicit(&(field), (value), memory_order_relaxed)
+
+static inline uint64_t pack_data(Move move, int score, int eval, int depth,
+                                 int genbound) {
+  return (uint64_t)move | ((uint64_t)(uint16_t)score << 16) |
+         ((uint64_t)(uint16_t)eval << 32) | ((uint64_t)depth << 48) |
+         ((uint64_t)genbound << 56);
+}
+
+static inline Move data_move(uint64_t data) { return (Move)data; }
+static inline int data_score(uint64_t data) { return (int16_t)(data >> 16); }
+static inline int data_eval(uint64_t data) { return (int16_t)(data >> 32); }
+static inline int data_depth(uint64_t data) { return (uint8_t)(data >> 48); }
+static inline int data_genbound(uint64_t data) { return (uint8_t)(data >> 56); }
+
+// Ancienneté en recherches, correcte malgré le rebouclage de l'age
+static inline int data_relative_age(const TranspositionTable *tt,
+                                    uint64_t data) {
+  return (TT_AGE_CYCLE + tt->current_age - (data_genbound(data) >> 3)) &
+         TT_AGE_MASK;
+}
+
+// Valeur d'une entrée pour le remplacement : la plus faible est écrasée
+static inline int data_worth(const TranspositionTable *tt, uint64_t data) {
+  return data_depth(data) - 8 * data_relative_age(tt, data);
+}
+
 // ========== INITIALISATION ==========
 
 void tt_init(TranspositionTable *tt) {
   memset(tt, 0, sizeof(TranspositionTable));
   tt->current_age = 1;
+}
+
+size_t tt_resize(TranspositionTable *tt, size_t size_mb) {
+  if (size_mb < 1)
+    size_mb = 1;
+  if (size_mb > TT_MAX_SIZE_MB)
+    size_mb = TT_MAX_SIZE_MB;
+
+  free(tt->memory);
+  tt->memory = NULL;
+  tt->clusters = NULL;
+  tt->cluster_count = 0;
+  tt->size_mb = 0;
+
+  // calloc : les pages à zéro ne sont réellement occupées qu'au premier
+  // accès, même pour plusieurs dizaines de Go. Une ligne de cache de plus
+  // permet d'aligner le début de la table
+  for (; size_mb >= 1; size_mb /= 2) {
+    size_t count = (size_mb << 20) / sizeof(TTCluster);
+    tt->memory = calloc(1, count * sizeof(TTCluster) + CACHE_LINE_SIZE);
+    if (tt->memory) {
+      uintptr_t aligned = ((uintptr_t)tt->memory + CACHE_LINE_SIZE - 1) &
+                          ~(uintptr_t)(CACHE_LINE_SIZE - 1);
+      tt->clusters = (TTCluster *)aligned;
+      tt->cluster_count = count;
+      tt->size_mb = size_mb;
+      break;
+    }
+    DEBUG_LOG("TT : échec d'allocation de %zu MB, essai plus petit\n",
+              size_mb);
+  }
+  tt->current_age = 1;
 
 #ifdef DEBUG
-  DEBUG_LOG("TT initialisée : %zu entrées (%zu bytes)\n", (size_t)TT_SIZE,
-            sizeof(TranspositionTable));
+  DEBUG_LOG("TT allouée : %zu clusters de %d entrées (%zu MB)\n",
+            tt->cluster_count, TT_CLUSTER_SIZE, tt->size_mb);
 #endif
+  return tt->size_mb;
+}
+
+void tt_clear(TranspositionTable *tt) {
+  if (tt->clusters)
+    memset(tt->clusters, 0, tt->cluster_count * sizeof(TTCluster));
+  tt->current_age = 1;
+}
+
+// Cluster par multiplication : répartit la clé sur [0, cluster_count) quelle
+// que soit la taille (les bits hauts de la clé sont utilisés)
+static inline TTCluster *tt_cluster(const TranspositionTable *tt,
+                                    uint64_t key) {
+  return &tt->clusters[((__uint128_t)key * tt->cluster_count) >> 64];
 }
 
 // ========== STOCKAGE ==========
 
 void tt_store(TranspositionTable *tt, uint64_t key, int depth, int score,
-              TTEntryType type, Move best_move, int ply) {
-  uint32_t index = key & TT_MASK;
-  TTEntry *entry = &tt->entries[index];
+              TTEntryType type, Move best_move, int eval, int is_pv, int ply) {
+  // Table pas encore allouée
+  if (tt->clusters == NULL)
+    return;
 
   // VALIDATION : key ne doit JAMAIS être 0
   if (key == 0) {
 #ifdef DEBUG
-    static int zero_key_warnings = 0;
+    static _Thread_local int zero_key_warnings = 0;
     if (zero_key_warnings++ < 3) {
       DEBUG_LOG("WARNING: tt_store() appelé avec key=0 !\n");
     }
@@ -40,97 +126,133 @@ void tt_store(TranspositionTable *tt, uint64_t key, int depth, int score,
     return; // NE PAS STOCKER
   }
 
-  // Stratégie de remplacement améliorée :
-  // 1. Case vide (key == 0)
-  // 2. Même position (key == entry->key)
-  // 3. Profondeur supérieure (depth > entry->depth)
-  // 4. Entrée obsolète (age < current_age - 2)
-
-  int should_replace = 0;
-
-  if (entry->key == 0) {
-    should_replace = 1; // Case vide
-  } else if (entry->key == key) {
-    should_replace = 1; // Même position (mise à jour)
-  } else if (depth > entry->depth) {
-    should_replace = 1; // Profondeur supérieure (info plus précise)
-  } else if (entry->age < tt->current_age - 2) {
-    should_replace = 1; // Entrée trop ancienne (2 recherches en arrière)
-  }
+  TTCluster *cluster = tt_cluster(tt, key);
 
-  if (should_replace) {
-    // Adjust mate scores: convert from "mate in N from current position"
-    // to "mate in N from root" by adding ply distance
-    int adjusted_score = score;
-    if (score >= MATE_SCORE - TT_MATE_THRESHOLD) { // Mate score for us
-      adjusted_score = score + ply;
-    } else if (score <= -MATE_SCORE + TT_MATE_THRESHOLD) { // Mate score against us
-      adjusted_score = score - ply;
+  // Choix de l'entrée dans le cluster :
+  // 1. Même position (mise à jour)
+  // 2. Case vide (depth == 0)
+  // 3. Sinon l'entrée de plus faible valeur (peu profonde ou ancienne)
+  TTEntry *replace = &cluster->entry[0];
+  uint64_t replace_data = TT_LOAD(replace->data);
+  int same_position = 0;
+  for (int i = 0; i < TT_CLUSTER_SIZE; i++) {
+    TTEntry *entry = &cluster->entry[i];
+    uint64_t data = TT_LOAD(entry->data);
+    uint64_t entry_key = TT_LOAD(entry->key_xor_data) ^ data;
+    if (entry_key == key || data_depth(data) == 0) {
+      replace = entry;
+      replace_data = data;
+      same_position = (entry_key == key);
+      break;
+    }
+    if (data_worth(tt, data) < data_worth(tt, replace_data)) {
+      replace = entry;
+      replace_data = data;
     }
+  }
+
+  // Garder le coup connu si la nouvelle recherche n'en a pas trouvé
+  if (best_move == MOVE_NONE && same_position)
+    best_move = data_move(replace_data);
+
+  // Adjust mate scores: convert from "mate in N from current position"
+  // to "mate in N from root" by adding ply distance
+  int adjusted_score = score;
+  if (score >= MATE_SCORE - TT_MATE_THRESHOLD) { // Mate score for us
+    adjusted_score = score + ply;
+  } else if (score <= -MATE_SCORE + TT_MATE_THRESHOLD) { // Mate score against us
+    adjusted_score = score - ply;
+  }
+
+  // Le score tient sur 16 bits (scores de mat compris)
+  if (adjusted_score > INT16_MAX)
+    adjusted_score = INT16_MAX;
+  if (adjusted_score < -INT16_MAX)
+    adjusted_score = -INT16_MAX;
 
-    entry->key = key;
-    entry->depth = depth;
-    entry->score = adjusted_score;
-    entry->type = type;
-    entry->best_move = best_move;
-    entry->age = tt->current_age;
+  // Profondeur bornée à [1, 255] : 0 est réservé aux entrées vides
+  if (depth < 1)
+    depth = 1;
+  if (depth > 255)
+    depth = 255;
+
+  int genbound = (tt->current_age << 3) | ((is_pv ? 1 : 0) << 2) | type;
+  uint64_t data = pack_data(best_move, adjusted_score, eval, depth, genbound);
+
+  // Deux écritures indépendantes : un lecteur qui voit un mélange de deux
+  // entrées obtient une clé invalide
+  TT_STORE(replace->key_xor_data, key ^ data);
+  TT_STORE(replace->data, data);
 
 #ifdef DEBUG
-    static int store_count = 0;
-    if (store_count++ < 10) {
-      DEBUG_LOG("TT_STORE: index=%u key=%016llx depth=%d score=%d->%d ply=%d\n",
-                index, (unsigned long long)key, depth, score, adjusted_score,
-                ply);
-    }
-#endif
+  static _Thread_local int store_count = 0;
+  if (store_count++ < 10) {
+    DEBUG_LOG("TT_STORE: slot=%d key=%016llx depth=%d score=%d->%d ply=%d\n",
+              (int)(replace - cluster->entry), (unsigned long long)key, depth,
+              score, adjusted_score, ply);
   }
+#endif
 }
 
 // ========== SONDAGE ==========
 
-TTEntry *tt_probe(TranspositionTable *tt, uint64_t key, int ply,
-                  int *score_out) {
+int tt_probe(TranspositionTable *tt, uint64_t key, int ply, TTData *tt_data) {
   // VALIDATION : key ne doit JAMAIS être 0
   if (key == 0) {
 #ifdef DEBUG
-    static int zero_key_probes = 0;
+    static _Thread_local int zero_key_probes = 0;
     if (zero_key_probes++ < 3) {
       DEBUG_LOG("WARNING: tt_probe() appelé avec key=0 !\n");
     }
 #endif
-    return NULL;
+    return 0;
   }
 
-  uint32_t index = key & TT_MASK;
-  TTEntry *entry = &tt->entries[index];
+  if (tt->clusters == NULL)
+    return 0;
+
+  TTCluster *cluster = tt_cluster(tt, key);
+
+  for (int i = 0; i < TT_CLUSTER_SIZE; i++) {
+    TTEntry *entry = &cluster->entry[i];
+    // Une seule lecture de chaque mot : la vérification et le décodage
+    // portent sur la même copie
+    uint64_t data = TT_LOAD(entry->data);
+    uint64_t key_xor_data = TT_LOAD(entry->key_xor_data);
+    // Vérifier que la clé match (entrée non déchirée) ET qu'elle n'est pas vide
+    if ((key_xor_data ^ data) != key || data_depth(data) == 0)
+      continue;
 
-  // Vérifier que la clé match ET que l'entrée n'est pas vide
-  if (entry->key == key && entry->depth > 0) {
     // Adjust mate scores: convert from "mate in N from root"
     // to "mate in N from current position" by subtracting ply distance
-    int adjusted_score = entry->score;
-    if (entry->score >= MATE_SCORE - TT_MATE_THRESHOLD) { // Mate score for us
-      adjusted_score = entry->score - ply;
-    } else if (entry->score <= -MATE_SCORE + TT_MATE_THRESHOLD) { // Mate score against us
-      adjusted_score = entry->score + ply;
+    int score = data_score(data);
+    int adjusted_score = score;
+    if (score >= MATE_SCORE - TT_MATE_THRESHOLD) { // Mate score for us
+      adjusted_score = score - ply;
+    } else if (score <= -MATE_SCORE + TT_MATE_THRESHOLD) { // Mate score against us
+      adjusted_score = score + ply;
     }
 
-    if (score_out != NULL) {
-      *score_out = adjusted_score;
-    }
+    int genbound = data_genbound(data);
+    tt_data->best_move = data_move(data);
+    tt_data->score = adjusted_score;
+    tt_data->eval = data_eval(data);
+    tt_data->depth = data_depth(data);
+    tt_data->type = (TTEntryType)(genbound & 0x3);
+    tt_data->is_pv = (genbound >> 2) & 1;
 
 #ifdef DEBUG
-    static int hit_count = 0;
+    static _Thread_local int hit_count = 0;
     if (hit_count++ < 10) {
-      DEBUG_LOG("TT_HIT: index=%u key=%016llx depth=%d score=%d->%d ply=%d\n",
-                index, (unsigned long long)key, entry->depth, entry->score,
+      DEBUG_LOG("TT_HIT: slot=%d key=%016llx depth=%d score=%d->%d ply=%d\n",
+                i, (unsigned long long)key, data_depth(data), score,
                 adjusted_score, ply);
     }
 #endif
-    return entry;
+    return 1;
   }
 
-  return NULL; // Pas trouvé
+  return 0; // Pas trouvé
 }
 
 // ========== NOUVELLE RECHERCHE ==========
@@ -138,14 +260,29 @@ TTEntry *tt_probe(TranspositionTable *tt, uint64_t key, int ply,
 void tt_new_search(TranspositionTable *tt) {
   // Increment age for new search - old entries will be replaced naturally
   // Do NOT clear the table - we want to reuse entries across moves!
-  tt->current_age++;
-  
-  // Prevent age overflow (very unlikely but defensive)
-  if (tt->current_age >= TT_MAX_AGE) {
-    tt->current_age = 1;
-  }
+  // L'age boucle sur TT_AGE_BITS bits (voir entry_relative_age)
+  tt->current_age = (tt->current_age + 1) & TT_AGE_MASK;
 
 #ifdef DEBUG
   DEBUG_LOG("TT_NEW_SEARCH: age incremented to %d\n", tt->current_age);
 #endif
 }
+
+int tt_hashfull(const TranspositionTable *tt) {
+  if (tt->clusters == NULL)
+    return 0;
+
+  size_t sample = 1000 / TT_CLUSTER_SIZE;
+  if (sample > tt->cluster_count)
+    sample = tt->cluster_count;
+
+  int used = 0;
+  for (size_t c = 0; c < sample; c++) {
+    for (int e = 0; e < TT_CLUSTER_SIZE; e++) {
+      uint64_t data = TT_LOAD(tt->clusters[c].entry[e].data);
+      if (data_depth(data) != 0 && data_relative_age(tt, data) == 0)
+        used++;
+    }
+  }
+  return (int)(used * 1000 / (sample * TT_CLUSTER_SIZE));
+}
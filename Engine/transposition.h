@@ -3,15 +3,29 @@
 
 #include "board.h"
 #include "movegen.h"
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdint.h>
 
-// Taille de la table de transposition (2^20 = 1M entrées)
-#define TT_SIZE 1048576
-#define TT_MASK (TT_SIZE - 1)
+// Taille de la table de transposition en MB (option UCI Hash). N'importe
+// quelle taille est acceptée : l'index est calculé par multiplication
+// (key * nombre de clusters) >> 64, sans masque de puissance de 2
+#define TT_DEFAULT_SIZE_MB 16
+#define TT_MAX_SIZE_MB 33554432 // 32 To
 
 // Constantes pour la gestion des scores de mat
 #define TT_MATE_THRESHOLD 128  // Distance max depuis MATE_SCORE pour détecter un mat
-#define TT_MAX_AGE 250         // Age maximum avant réinitialisation
+
+// Génération (age) sur 5 bits : elle boucle, seul l'écart relatif compte
+#define TT_AGE_BITS 5
+#define TT_AGE_CYCLE (1 << TT_AGE_BITS)
+#define TT_AGE_MASK (TT_AGE_CYCLE - 1)
+
+// Évaluation statique absente de l'entrée
+#define TT_EVAL_NONE INT16_MIN
+
+// Entrées par cluster : 4 x 16 octets = une ligne de cache de 64 octets
+#define TT_CLUSTER_SIZE 4
 
 // Type d'entrée dans la table de transposition
 typedef enum {
@@ -20,34 +34,69 @@ typedef enum {
   TT_LOWERBOUND  // Borne inférieure (fail-high)
 } TTEntryType;
 
-// Entrée de la table de transposition
+// Entrée de 16 octets partagée sans verrou entre les threads (Lazy SMP).
+// Les données tiennent dans un mot de 64 bits :
+//   bits 0-15  meilleur coup
+//   bits 16-31 score (int16, mats relatifs à la racine)
+//   bits 32-47 évaluation statique (int16, TT_EVAL_NONE si inconnue)
+//   bits 48-55 profondeur (0 = entrée vide)
+//   bits 56-63 age << 3 | pv << 2 | type
+// La clé est stockée XOR les données : une entrée déchirée par deux
+// écritures concurrentes ne vérifie plus aucune clé et est ignorée
 typedef struct {
-  uint64_t key;     // Zobrist hash key
-  int depth;        // Profondeur de recherche
-  int score;        // Score de la position
-  TTEntryType type; // Type d'entrée
-  Move best_move;   // Meilleur mouvement trouvé
-  uint8_t age;      // Age de l'entrée (pour remplacement)
+  _Atomic uint64_t key_xor_data;
+  _Atomic uint64_t data;
 } TTEntry;
 
-// Table de transposition globale
+// Cluster aligné : une sonde ne touche qu'une ligne de cache
+typedef struct {
+  TTEntry entry[TT_CLUSTER_SIZE];
+} __attribute__((aligned(64))) TTCluster;
+
+// Copie décodée d'une entrée trouvée par tt_probe
 typedef struct {
-  TTEntry entries[TT_SIZE];
-  uint8_t current_age;
+  Move best_move;
+  int score; // Score ajusté au ply courant
+  int eval;  // TT_EVAL_NONE si inconnue
+  int depth;
+  TTEntryType type;
+  int is_pv; // Stockée depuis un noeud PV
+} TTData;
+
+// Table de transposition globale (allouée sur le tas)
+typedef struct {
+  void *memory;         // Bloc alloué (libéré par free)
+  TTCluster *clusters;  // Début aligné sur 64 octets dans memory
+  size_t cluster_count; // Pas forcément une puissance de 2
+  size_t size_mb;       // Taille effectivement allouée
+  uint8_t current_age;  // Génération courante (TT_AGE_BITS bits)
 } TranspositionTable;
 
-// Initialise la table de transposition
+// Initialise une table vide, sans allocation (sondes et stockages sont
+// ignorés tant que tt_resize n'a pas été appelé)
 void tt_init(TranspositionTable *tt);
 
-// Stocke une entrée dans la table
+// (Ré)alloue la table à size_mb MB, vide. En cas d'échec d'allocation, la
+// taille est divisée par 2 jusqu'à réussir. Retourne la taille obtenue en MB
+size_t tt_resize(TranspositionTable *tt, size_t size_mb);
+
+// Vide la table sans changer sa taille (ucinewgame)
+void tt_clear(TranspositionTable *tt);
+
+// Stocke une entrée dans le cluster de la clé : même position, sinon case
+// vide, sinon l'entrée de plus faible valeur (profondeur - 8 * ancienneté)
 void tt_store(TranspositionTable *tt, uint64_t key, int depth, int score,
-              TTEntryType type, Move best_move, int ply);
+              TTEntryType type, Move best_move, int eval, int is_pv, int ply);
 
-// Sonde la table (retourne NULL si pas trouvé, score ajusté retourné dans score_out si non-NULL)
-TTEntry *tt_probe(TranspositionTable *tt, uint64_t key, int ply,
-                  int *score_out);
+// Sonde le cluster de la clé. Retourne 1 et remplit tt_data (score ajusté au
+// ply) si la position est trouvée, 0 sinon (entrées déchirées ignorées)
+int tt_probe(TranspositionTable *tt, uint64_t key, int ply, TTData *tt_data);
 
 // Nouvelle recherche (incrémente l'age)
 void tt_new_search(TranspositionTable *tt);
 
+// Remplissage en pour mille (info hashfull) : entrées de la recherche
+// courante parmi les 1000 premières de la table
+int tt_hashfull(const TranspositionTable *tt);
+
 #endif // TRANSPOSITION_H
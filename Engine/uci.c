@@ -1,7 +1,10 @@
 #include "uci.h"
+#include "bench.h"
 #include "perft.h"
 #include "search.h"
 #include "timemanager.h"
+#include <inttypes.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,12 +17,39 @@
       fprintf(stderr, "[UCI] " __VA_ARGS__);                                   \
   } while (0)
 
-volatile bool stop_search_flag = false; // Variable pour arrêter la recherche
-volatile int uci_debug = 0;             // Debug dynamique (0 ou 1)
+volatile int uci_debug = 0; // Debug dynamique (0 ou 1)
+
+// Recherche en cours sur un thread dédié : la boucle UCI continue de lire
+// stdin (stop, isready, quit) pendant la recherche. Ces variables ne sont
+// touchées que par le thread UCI
+typedef struct {
+  Board board; // Copie : "position" peut arriver pendant la recherche
+  int max_depth;
+  SearchLimits limits;
+  int infinite; // Ne s'arrête que sur stop/quit
+  int ponder;   // En ponder jusqu'à ponderhit
+} SearchJob;
+
+static SearchJob search_job;
+static pthread_t search_thread;
+static bool search_running = false;
+
+// En "go infinite" ou "go ponder", bestmove est retenu jusqu'à stop (ou
+// ponderhit) même si la recherche s'est terminée avant
+static pthread_mutex_t bestmove_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bestmove_cond = PTHREAD_COND_INITIALIZER;
+static bool bestmove_held = false;
+
+static void wait_for_search(void);
+static void stop_search(void);
+static int find_legal_move(Board *board, const char *uci_str, Move *out);
 
 // Options UCI configurables
 UCIOptions uci_options = {
-    .hash_size_mb = 16, // Défaut: 16 MB
+    .hash_size_mb = TT_DEFAULT_SIZE_MB, // Défaut: 16 MB
+    .threads = 1,       // Défaut: un seul thread
+    .multipv = 1,       // Défaut: meilleure ligne seulement
+    .move_overhead_ms = DEFAULT_MOVE_OVERHEAD_MS,
     .ponder = 0,        // Défaut: désactivé
     .own_book = 0,      // Défaut: pas de livre
     .analyse_mode = 0   // Défaut: mode normal
@@ -36,8 +66,14 @@ void uci_loop() {
 
   while (1) {
     memset(line, 0, sizeof(line));
-    if (!fgets(line, sizeof(line), stdin))
+    if (!fgets(line, sizeof(line), stdin)) {
+      // Fin de l'entrée : une recherche bornée va au bout, une recherche
+      // infinie est arrêtée (sinon bestmove ne viendrait jamais)
+      if (search_running && (search_job.infinite || search_job.ponder))
+        stop_search();
+      wait_for_search();
       break;
+    }
 
     // Supprimer le \n
     line[strcspn(line, "\n")] = 0;
@@ -49,28 +85,78 @@ void uci_loop() {
   }
 }
 
-// Gestionnaire commande "perft"
+// Gestionnaire commande "bench [depth] [threads] [hash]"
+void handle_bench(char *params) {
+  // Le bench réutilise les threads et la table de la recherche
+  stop_search();
+
+  int depth = BENCH_DEFAULT_DEPTH;
+  int threads = BENCH_DEFAULT_THREADS;
+  int hash_mb = BENCH_DEFAULT_HASH_MB;
+  if (params)
+    sscanf(params, "%d %d %d", &depth, &threads, &hash_mb);
+  if (hash_mb < 1 || hash_mb > TT_MAX_SIZE_MB)
+    hash_mb = BENCH_DEFAULT_HASH_MB;
+
+  bench_run(depth, threads, hash_mb);
+
+  // Rétablir les options de l'interface (la table repart vide)
+  search_set_threads(uci_options.threads);
+  search_set_hash_size((size_t)uci_options.hash_size_mb);
+  search_set_multipv(uci_options.multipv);
+}
+
+// Paramètres "<depth> [threads] [hash]" de perft et go perft (threads par
+// défaut : option UCI Threads ; hash en MB, 0 par défaut : pas de table).
+// Retourne 0 si la profondeur est invalide
+static int parse_perft_params(const char *params, int *depth, int *threads,
+                              int *hash_mb) {
+  *depth = 0;
+  *threads = uci_options.threads;
+  *hash_mb = 0;
+  if (params)
+    sscanf(params, "%d %d %d", depth, threads, hash_mb);
+  if (*threads < 1 || *threads > PERFT_MAX_THREADS)
+    *threads = uci_options.threads;
+  if (*hash_mb < 0 || *hash_mb > PERFT_MAX_HASH_MB)
+    *hash_mb = 0;
+
+  if (*depth < 1 || *depth > 10) {
+    printf("info string perft depth must be between 1 and 10\n");
+    fflush(stdout);
+    return 0;
+  }
+  return 1;
+}
+
+// Gestionnaire commande "perft <depth> [threads] [hash]"
 void handle_perft(Board *board, char *params) {
+  // Pas de perft pendant une recherche (threads et sorties mélangés)
+  stop_search();
+
   if (params == NULL) {
     printf("info string perft requires depth parameter\n");
     fflush(stdout);
     return;
   }
 
-  int depth = atoi(params);
-  if (depth < 1 || depth > 10) {
-    printf("info string perft depth must be between 1 and 10\n");
-    fflush(stdout);
+  int depth, threads, hash_mb;
+  if (!parse_perft_params(params, &depth, &threads, &hash_mb))
     return;
-  }
 
-  // Utiliser perft_divide pour afficher chaque coup et son nombre de
-  // positions
-  perft_divide(board, depth);
-
-  // Calculer et afficher le total
-  unsigned long total = perft(board, depth);
-  printf("Total: %lu\n", total);
+  // perft_divide affiche chaque coup et son nombre de positions, et
+  // retourne le total. La table n'est gardée que le temps de la commande
+  perft_set_hash_size((size_t)hash_mb);
+  long start_ms = get_time_ms();
+  uint64_t total = perft_divide(board, depth, threads);
+  long elapsed_ms = get_time_ms() - start_ms;
+  perft_set_hash_size(0);
+  if (elapsed_ms < 1)
+    elapsed_ms = 1;
+
+  printf("Total: %" PRIu64 "\n", total);
+  printf("info string perft time %ld nps %" PRIu64 " threads %d\n",
+         elapsed_ms, total * 1000 / (uint64_t)elapsed_ms, threads);
   fflush(stdout);
 }
 
@@ -82,7 +168,17 @@ void handle_uci() {
   fflush(stdout);
 
   // Envoyer les options supportées (obligatoire pour conformité UCI)
-  printf("option name Hash type spin default 16 min 1 max 1024\n");
+  printf("option name Hash type spin default %d min 1 max %d\n",
+         TT_DEFAULT_SIZE_MB, TT_MAX_SIZE_MB);
+  fflush(stdout);
+  printf("option name Threads type spin default 1 min 1 max %d\n",
+         SEARCH_MAX_THREADS);
+  fflush(stdout);
+  printf("option name MultiPV type spin default 1 min 1 max %d\n",
+         SEARCH_MAX_MULTIPV);
+  fflush(stdout);
+  printf("option name Move Overhead type spin default %d min 0 max %d\n",
+         DEFAULT_MOVE_OVERHEAD_MS, MAX_MOVE_OVERHEAD_MS);
   fflush(stdout);
   printf("option name Ponder type check default false\n");
   fflush(stdout);
@@ -142,12 +238,41 @@ void handle_setoption(char *params) {
     option_name[sizeof(option_name) - 1] = '\0';
   }
 
+  // Les options ne changent pas pendant une recherche (la table de
+  // transposition peut être réallouée)
+  stop_search();
+
   // Traiter les options connues
   if (strcmp(option_name, "Hash") == 0 && value_token) {
     int hash_mb = atoi(value_token);
-    if (hash_mb >= 1 && hash_mb <= 1024) {
-      uci_options.hash_size_mb = hash_mb;
-      DEBUG_LOG_UCI("Hash set to %d MB\n", hash_mb);
+    if (hash_mb >= 1 && hash_mb <= TT_MAX_SIZE_MB) {
+      // Réallocation immédiate (la table repart vide)
+      size_t allocated_mb = search_set_hash_size((size_t)hash_mb);
+      uci_options.hash_size_mb = (int)allocated_mb;
+      if (allocated_mb != (size_t)hash_mb) {
+        printf("info string Hash limited to %zu MB (allocation failed)\n",
+               allocated_mb);
+        fflush(stdout);
+      }
+      DEBUG_LOG_UCI("Hash set to %zu MB\n", allocated_mb);
+    }
+  } else if (strcmp(option_name, "Threads") == 0 && value_token) {
+    int threads = atoi(value_token);
+    if (threads >= 1 && threads <= SEARCH_MAX_THREADS) {
+      uci_options.threads = search_set_threads(threads);
+      DEBUG_LOG_UCI("Threads set to %d\n", uci_options.threads);
+    }
+  } else if (strcmp(option_name, "MultiPV") == 0 && value_token) {
+    int multipv = atoi(value_token);
+    if (multipv >= 1 && multipv <= SEARCH_MAX_MULTIPV) {
+      uci_options.multipv = search_set_multipv(multipv);
+      DEBUG_LOG_UCI("MultiPV set to %d\n", uci_options.multipv);
+    }
+  } else if (strcmp(option_name, "Move Overhead") == 0 && value_token) {
+    int overhead_ms = atoi(value_token);
+    if (overhead_ms >= 0 && overhead_ms <= MAX_MOVE_OVERHEAD_MS) {
+      uci_options.move_overhead_ms = overhead_ms;
+      DEBUG_LOG_UCI("Move Overhead set to %d ms\n", overhead_ms);
     }
   } else if (strcmp(option_name, "Ponder") == 0 && value_token) {
     uci_options.ponder = (strcmp(value_token, "true") == 0) ? 1 : 0;
@@ -175,6 +300,8 @@ void handle_register(char *params) {
 
 // Gestionnaire commande "ucinewgame"
 void handle_ucinewgame() {
+  // La table ne doit pas être vidée sous une recherche en cours
+  stop_search();
   // Clear transposition table and reset search state for a new game
   initialize_engine();
   DEBUG_LOG_UCI("New game started, engine reset\n");
@@ -186,7 +313,7 @@ void setup_startpos(Board *board) {
   board_from_fen(board,
                  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
   board->to_move = WHITE;
-  board->en_passant = -1;
+  board->en_passant = NO_SQUARE;
   board->halfmove_clock = 0;
   board->move_number = 1;
 }
@@ -228,55 +355,51 @@ void handle_position(Board *board, char *params) {
   }
 }
 
-// Parser un coup UCI (ex: "e2e4" -> Move)
+// Parser un coup UCI (ex: "e2e4" -> Move). Seules les cases et la pièce de
+// promotion sont connues : le type exact (capture, roque...) vient de la
+// liste des coups légaux
 Move parse_uci_move(const char *uci_str) {
-  Move move;
-  memset(&move, 0, sizeof(move));
-
   if (!uci_str)
-    return move;
+    return MOVE_NONE;
   size_t len = strlen(uci_str);
   if (len < 4)
-    return move;
+    return MOVE_NONE;
 
   int file_from = uci_str[0] - 'a';
   int rank_from = uci_str[1] - '1';
   int file_to = uci_str[2] - 'a';
   int rank_to = uci_str[3] - '1';
+  if (file_from < 0 || file_from > 7 || rank_from < 0 || rank_from > 7 ||
+      file_to < 0 || file_to > 7 || rank_to < 0 || rank_to > 7)
+    return MOVE_NONE;
 
-  move.from = rank_from * 8 + file_from;
-  move.to = rank_to * 8 + file_to;
-  move.type = MOVE_NORMAL;
-  move.promotion = EMPTY;
+  Square from = rank_from * 8 + file_from;
+  Square to = rank_to * 8 + file_to;
 
   // Promotion possible si un 5ème caractère est fourni
   if (len >= 5) {
-    move.type = MOVE_PROMOTION;
-    char p = uci_str[4];
-    switch (p) {
-    case 'q':
-    case 'Q':
-      move.promotion = QUEEN;
-      break;
+    PieceType promotion;
+    switch (uci_str[4]) {
     case 'r':
     case 'R':
-      move.promotion = ROOK;
+      promotion = ROOK;
       break;
     case 'b':
     case 'B':
-      move.promotion = BISHOP;
+      promotion = BISHOP;
       break;
     case 'n':
     case 'N':
-      move.promotion = KNIGHT;
+      promotion = KNIGHT;
       break;
     default:
-      move.promotion = QUEEN; // fallback raisonnable
+      promotion = QUEEN; // 'q' ou fallback raisonnable
       break;
     }
+    return create_promotion_move(from, to, promotion, 0);
   }
 
-  return move;
+  return create_move(from, to, MOVE_NORMAL);
 }
 
 // Récupère un coup d'urgence (premier coup légal disponible)
@@ -296,21 +419,22 @@ static int get_emergency_move(Board *board, Move *out_move) {
 
 // Valide qu'un coup est légal et le corrige si nécessaire
 static int validate_and_fix_move(Board *board, Move *move) {
-  // Validation 1: Coup invalide (from == -1 ou from == to)
-  if (move->from == -1 || move->to == -1 || move->from == move->to) {
-    DEBUG_LOG_UCI("❌ Invalid move structure (from=%d, to=%d)\n", move->from,
-                  move->to);
+  // Validation 1: Coup invalide (MOVE_NONE ou from == to)
+  Square from = MOVE_FROM(*move);
+  Square to = MOVE_TO(*move);
+  if (from == to) {
+    DEBUG_LOG_UCI("❌ Invalid move structure (from=%d, to=%d)\n", from, to);
     return get_emergency_move(board, move);
   }
 
   // Validation 2: Vérifier qu'une pièce valide existe sur la case from
-  PieceType piece_on_from = get_piece_type(board, move->from);
-  Couleur color_on_from = get_piece_color(board, move->from);
+  PieceType piece_on_from = get_piece_type(board, from);
+  Couleur color_on_from = get_piece_color(board, from);
 
   if (piece_on_from == EMPTY || color_on_from != board->to_move) {
     DEBUG_LOG_UCI("❌ No valid piece on from square! from=%c%d piece=%d "
                   "color=%d expected_color=%d\n",
-                  'a' + (move->from % 8), 1 + (move->from / 8), piece_on_from,
+                  'a' + (from % 8), 1 + (from / 8), piece_on_from,
                   color_on_from, board->to_move);
     return get_emergency_move(board, move);
   }
@@ -320,11 +444,7 @@ static int validate_and_fix_move(Board *board, Move *move) {
   generate_legal_moves(board, &legal_moves);
 
   for (int i = 0; i < legal_moves.count; i++) {
-    if (legal_moves.moves[i].from == move->from &&
-        legal_moves.moves[i].to == move->to &&
-        legal_moves.moves[i].type == move->type) {
-      // Utiliser le coup exact de la liste légale
-      *move = legal_moves.moves[i];
+    if (legal_moves.moves[i] == *move) {
       return 1;
     }
   }
@@ -334,10 +454,90 @@ static int validate_and_fix_move(Board *board, Move *move) {
   return get_emergency_move(board, move);
 }
 
+// ========== THREAD DE RECHERCHE ==========
+
+// Corps du thread de recherche : cherche puis envoie toujours bestmove
+static void *search_thread_main(void *arg) {
+  SearchJob *job = (SearchJob *)arg;
+
+  SearchResult result = search_iterative_deepening(
+      &job->board, job->max_depth, &job->limits);
+
+  DEBUG_LOG_UCI("Search complete: depth=%d, score=%d, nodes=%" PRIu64
+                ", nps=%" PRIu64 "\n",
+                result.depth, result.score, result.nodes, result.nps);
+
+  // Ne pas répondre avant stop/ponderhit (protocole UCI)
+  pthread_mutex_lock(&bestmove_mutex);
+  while (bestmove_held)
+    pthread_cond_wait(&bestmove_cond, &bestmove_mutex);
+  pthread_mutex_unlock(&bestmove_mutex);
+
+  // Valider et corriger le coup si nécessaire
+  if (!validate_and_fix_move(&job->board, &result.best_move)) {
+    // Aucun coup légal disponible
+    printf("bestmove 0000\n");
+    fflush(stdout);
+    DEBUG_LOG_UCI("=== SEARCH END (NO LEGAL MOVES) ===\n\n");
+    return NULL;
+  }
+
+  // Envoyer le bestmove (info déjà envoyé par search_iterative_deepening),
+  // avec la réponse attendue pour le ponder si elle est connue
+  printf("bestmove %s", move_to_string(&result.best_move));
+  if (result.ponder_move != MOVE_NONE)
+    printf(" ponder %s", move_to_string(&result.ponder_move));
+  printf("\n");
+  fflush(stdout);
+
+  DEBUG_LOG_UCI("=== SEARCH END ===\n\n");
+  return NULL;
+}
+
+// Laisse le thread de recherche envoyer bestmove dès qu'il a terminé
+static void release_bestmove(void) {
+  pthread_mutex_lock(&bestmove_mutex);
+  bestmove_held = false;
+  pthread_cond_signal(&bestmove_cond);
+  pthread_mutex_unlock(&bestmove_mutex);
+}
+
+// Attend la fin de la recherche en cours (son bestmove est alors envoyé)
+static void wait_for_search(void) {
+  if (!search_running)
+    return;
+  pthread_join(search_thread, NULL);
+  search_running = false;
+}
+
+// Interrompt la recherche en cours et attend son bestmove
+static void stop_search(void) {
+  if (!search_running)
+    return;
+  search_request_stop();
+  release_bestmove();
+  wait_for_search();
+}
+
 // Gestionnaire commande "go"
 void handle_go(Board *board, char *params) {
   DEBUG_LOG_UCI("=== HANDLE_GO START ===\n");
-  stop_search_flag = false;
+
+  // Un seul thread de recherche à la fois
+  stop_search();
+
+  // "go perft <depth> [threads] [hash]" : test de génération avec
+  // statistiques
+  if (params && strncmp(params, "perft", 5) == 0) {
+    int depth, threads, hash_mb;
+    if (!parse_perft_params(params + 5, &depth, &threads, &hash_mb))
+      return;
+    perft_set_hash_size((size_t)hash_mb);
+    perft_test(board, depth, threads);
+    perft_set_hash_size(0);
+    fflush(stdout);
+    return;
+  }
 
   // Parser les paramètres (dupliquer car strtok modifie la chaîne)
   char params_copy[4096];
@@ -351,105 +551,128 @@ void handle_go(Board *board, char *params) {
   GoParams go_params;
   parse_go_params(params_copy, &go_params);
 
-  // Calculer le temps alloué
-  int time_limit_ms = calculate_time_for_move(board, &go_params);
+  // Calculer les limites de temps (souple : dernière itération commencée,
+  // dure : arrêt immédiat). La profondeur n'est plus bornée selon le temps :
+  // la limite souple arrête l'approfondissement
+  SearchLimits limits;
+  calculate_time_limits(board, &go_params, uci_options.move_overhead_ms,
+                        &limits.time);
+
+  // Budget de noeuds, mat en N et coups de la racine (searchmoves)
+  limits.nodes = go_params.nodes > 0 ? (uint64_t)go_params.nodes : 0;
+  limits.mate = go_params.mate > 0 ? go_params.mate : 0;
+  limits.searchmoves_count = 0;
+  for (int i = 0; i < go_params.searchmoves_count; i++) {
+    Move move;
+    if (find_legal_move(board, go_params.searchmoves[i], &move)) {
+      limits.searchmoves[limits.searchmoves_count++] = move;
+    } else {
+      printf("info string searchmoves: illegal move '%s' ignored\n",
+             go_params.searchmoves[i]);
+      fflush(stdout);
+    }
+  }
 
   int max_depth = 64;
 
   if (go_params.depth > 0) {
     max_depth = go_params.depth;
     DEBUG_LOG_UCI("Using fixed depth from go_params: %d\n", max_depth);
-  } else if (time_limit_ms > 0) {
-    // Adapt depth based on time available
-    if (time_limit_ms < 1000) {
-      max_depth = 10;
-    } else if (time_limit_ms < 3000) {
-      max_depth = 12;
-    } else if (time_limit_ms < 10000) {
-      max_depth = 18;
-    } else {
-      max_depth = 64;
-    }
-    DEBUG_LOG_UCI("Adaptive depth set to %d based on time limit %d ms\n",
-                  max_depth, time_limit_ms);
-  } else {
-    max_depth = 64;
-    DEBUG_LOG_UCI("No depth or time limit specified, using max_depth=%d\n",
-                  max_depth);
   }
 
-  DEBUG_LOG_UCI("Starting search: max_depth=%d, time_limit=%dms\n", max_depth,
-                time_limit_ms);
-
-  // Lancer la recherche
-  SearchResult result =
-      search_iterative_deepening(board, max_depth, time_limit_ms);
-
-  DEBUG_LOG_UCI("Search complete: depth=%d, score=%d, nodes=%d, nps=%d\n",
-                result.depth, result.score, result.nodes, result.nps);
-
-  // Valider et corriger le coup si nécessaire
-  if (!validate_and_fix_move(board, &result.best_move)) {
-    // Aucun coup légal disponible
-    printf("bestmove 0000\n");
-    fflush(stdout);
-    DEBUG_LOG_UCI("=== HANDLE_GO END (NO LEGAL MOVES) ===\n\n");
-    return;
+  DEBUG_LOG_UCI("Starting search: max_depth=%d, soft=%dms, hard=%dms, "
+                "nodes=%" PRIu64 ", mate=%d, searchmoves=%d\n",
+                max_depth, limits.time.soft_ms, limits.time.hard_ms,
+                limits.nodes, limits.mate, limits.searchmoves_count);
+
+  // Lancer la recherche sur son thread (drapeau d'arrêt remis à zéro avant :
+  // un stop qui suit immédiatement le go n'est pas perdu)
+  search_job.board = *board;
+  search_job.max_depth = max_depth;
+  search_job.limits = limits;
+  search_job.infinite = go_params.infinite;
+  search_job.ponder = go_params.ponder;
+  search_reset_stop();
+  // Ponder : pas de limite de temps avant ponderhit (le budget calculé
+  // ci-dessus s'appliquera alors)
+  search_set_ponder(go_params.ponder);
+  bestmove_held = go_params.infinite || go_params.ponder;
+
+  if (pthread_create(&search_thread, NULL, search_thread_main, &search_job) ==
+      0) {
+    search_running = true;
+  } else {
+    // Pas de thread disponible : recherche synchrone (personne ne pourrait
+    // libérer bestmove)
+    DEBUG_LOG_UCI("Search thread creation failed, searching synchronously\n");
+    bestmove_held = false;
+    search_set_ponder(0);
+    search_thread_main(&search_job);
   }
 
-  // Envoyer le bestmove (info déjà envoyé par search_iterative_deepening)
-  printf("bestmove %s\n", move_to_string(&result.best_move));
-  fflush(stdout);
-
   DEBUG_LOG_UCI("=== HANDLE_GO END ===\n\n");
 }
 
 // Gestionnaire commande "ponderhit"
 void handle_ponderhit() {
-  // Quand le moteur était en mode "ponder" et que le coup prédit a été joué
-  // On doit basculer la recherche en mode normal
-  // Pour l'instant, on reconnaît la commande sans l'implémenter
-  DEBUG_LOG_UCI("Ponderhit received (pondering not yet implemented)\n");
-  // TODO: Quand le pondering sera implémenté, basculer le temps en mode normal
+  // Le coup prédit a été joué : la recherche en cours continue avec le
+  // budget de temps normal, sans redémarrer (arbre et table conservés)
+  if (!search_running || !search_job.ponder) {
+    DEBUG_LOG_UCI("Ponderhit received without ponder search (ignored)\n");
+    return;
+  }
+  DEBUG_LOG_UCI("Ponderhit received, switching to normal search\n");
+  search_job.ponder = 0;
+  search_ponderhit();
+  // Une recherche déjà terminée répond tout de suite
+  if (!search_job.infinite)
+    release_bestmove();
 }
 
 // Gestionnaire commande "stop"
 void handle_stop() {
-  stop_search_flag = true;
   DEBUG_LOG_UCI("Stop command received\n");
-  fflush(stdout);
+  // bestmove est envoyé avant de lire la commande suivante
+  stop_search();
 }
 
 // Gestionnaire commande "quit"
 void handle_quit() {
   DEBUG_LOG_UCI("Quit command received, exiting\n");
+  stop_search();
   exit(0);
 }
 
-// Applique un coup UCI en mettant à jour l'état du board
+// Applique un coup UCI en mettant à jour l'état du board (make_move tient
+// aussi les compteurs de coups)
 void apply_uci_move(Board *board, const Move *move) {
-  Board dummy_backup;
-
-  // Sauvegarder les informations AVANT le coup
-  PieceType moving_piece = get_piece_type(board, move->from);
-  int is_capture =
-      (move->type == MOVE_CAPTURE || move->type == MOVE_EN_PASSANT);
-  Couleur moving_color = board->to_move;
+  UndoInfo undo;
+  make_move(board, move, &undo);
+}
 
-  // Appliquer le coup
-  make_move_temp(board, move, &dummy_backup);
+// Coup légal correspondant à un coup UCI (le type exact du coup vient de la
+// liste des coups légaux), retourne 0 s'il n'existe pas
+static int find_legal_move(Board *board, const char *uci_str, Move *out) {
+  Move uci_move = parse_uci_move(uci_str);
+  if (uci_move == MOVE_NONE)
+    return 0;
 
-  // Mettre à jour les compteurs de coups
-  if (moving_piece == PAWN || is_capture) {
-    board->halfmove_clock = 0;
-  } else {
-    board->halfmove_clock++;
-  }
+  MoveList legal_moves;
+  generate_legal_moves(board, &legal_moves);
 
-  // Compteur de coups complets (incrémenté après le coup des noirs)
-  if (moving_color == BLACK) {
-    board->move_number++;
+  // Logique de correspondance robuste
+  for (int i = 0; i < legal_moves.count; i++) {
+    Move legal = legal_moves.moves[i];
+    if (MOVE_FROM(legal) == MOVE_FROM(uci_move) &&
+        MOVE_TO(legal) == MOVE_TO(uci_move) &&
+        // Si promotion, vérifier aussi la pièce promue ; sinon la
+        // correspondance des cases suffit
+        MOVE_PROMOTION_PIECE(legal) == MOVE_PROMOTION_PIECE(uci_move)) {
+      *out = legal;
+      return 1;
+    }
   }
+  return 0;
 }
 
 // Appliquer une séquence de coups UCI
@@ -460,37 +683,8 @@ void apply_uci_moves(Board *board, char *moves_str) {
 
   char *move_str = strtok(moves_copy, " ");
   while (move_str != NULL) {
-    Move uci_move = parse_uci_move(move_str);
-
-    MoveList legal_moves;
-    generate_legal_moves(board, &legal_moves);
-
     Move actual_move;
-    int found = 0;
-
-    // Logique de correspondance robuste
-    for (int i = 0; i < legal_moves.count; i++) {
-      if (legal_moves.moves[i].from == uci_move.from &&
-          legal_moves.moves[i].to == uci_move.to) {
-
-        // Si promotion, vérifier aussi le type de promotion
-        if (uci_move.type == MOVE_PROMOTION) {
-          if (legal_moves.moves[i].type == MOVE_PROMOTION &&
-              legal_moves.moves[i].promotion == uci_move.promotion) {
-            actual_move = legal_moves.moves[i];
-            found = 1;
-            break;
-          }
-        } else {
-          // Pour les autres coups, la correspondance des cases suffit
-          actual_move = legal_moves.moves[i];
-          found = 1;
-          break;
-        }
-      }
-    }
-
-    if (found) {
+    if (find_legal_move(board, move_str, &actual_move)) {
       apply_uci_move(board, &actual_move);
     } else {
       printf("info string illegal move '%s' for side %d\n", move_str,
@@ -527,6 +721,9 @@ void parse_uci_command(char *line, Board *board) {
   } else if (strcmp(command, "go") == 0) {
     char *params = strtok(NULL, "");
     handle_go(board, params);
+  } else if (strcmp(command, "bench") == 0) {
+    char *params = strtok(NULL, "");
+    handle_bench(params);
   } else if (strcmp(command, "perft") == 0) {
     char *params = strtok(NULL, "");
     handle_perft(board, params);
@@ -10,6 +10,9 @@ extern volatile int uci_debug;
 // Structure pour les options UCI configurables
 typedef struct {
   int hash_size_mb; // Taille de la table de transposition (MB)
+  int threads;      // Threads de recherche (Lazy SMP)
+  int multipv;      // Lignes annoncées par itération (MultiPV)
+  int move_overhead_ms; // Marge de latence retirée du temps (ms)
   int ponder;       // Pondering activé (0/1)
   int own_book;     // Utiliser le livre d'ouvertures (0/1)
   int analyse_mode; // Mode analyse UCI (0/1)
@@ -1,8 +1,9 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/time.h>
+#include <time.h>
 
 // ============================================================================
 // UTILITAIRES D'AFFICHAGE ET CONVERSION
@@ -10,15 +11,17 @@
 
 // Affiche un coup en notation lisible
 void print_move(const Move *move) {
-  char from_str[3] = {'a' + (move->from % 8), '1' + (move->from / 8), '\0'};
-  char to_str[3] = {'a' + (move->to % 8), '1' + (move->to / 8), '\0'};
+  Square from = MOVE_FROM(*move);
+  Square to = MOVE_TO(*move);
+  char from_str[3] = {'a' + (from % 8), '1' + (from / 8), '\0'};
+  char to_str[3] = {'a' + (to % 8), '1' + (to / 8), '\0'};
 
   printf("%s%s", from_str, to_str);
 
-  switch (move->type) {
+  switch (MOVE_TYPE(*move)) {
   case MOVE_PROMOTION: {
     const char pieces[] = "PNBRQK";
-    printf("=%c", pieces[move->promotion]);
+    printf("=%c", pieces[MOVE_PROMOTION_PIECE(*move)]);
     break;
   }
   case MOVE_CASTLE:
@@ -48,14 +51,16 @@ void print_movelist(const MoveList *list) {
 // Convertit un coup en string (thread-safe avec buffer static)
 char *move_to_string(const Move *move) {
   static char buffer[16];
-  char from_str[3] = {'a' + (move->from % 8), '1' + (move->from / 8), '\0'};
-  char to_str[3] = {'a' + (move->to % 8), '1' + (move->to / 8), '\0'};
+  Square from = MOVE_FROM(*move);
+  Square to = MOVE_TO(*move);
+  char from_str[3] = {'a' + (from % 8), '1' + (from / 8), '\0'};
+  char to_str[3] = {'a' + (to % 8), '1' + (to / 8), '\0'};
 
   sprintf(buffer, "%s%s", from_str, to_str);
 
-  if (move->type == MOVE_PROMOTION) {
+  if (MOVE_IS_PROMOTION(*move)) {
     const char pieces[] = "pnbrqk"; // UCI utilise minuscules
-    sprintf(buffer + strlen(buffer), "%c", pieces[move->promotion]);
+    sprintf(buffer + strlen(buffer), "%c", pieces[MOVE_PROMOTION_PIECE(*move)]);
   }
 
   return buffer;
@@ -135,44 +140,40 @@ int count_pieces(const Board *board, PieceType piece, Couleur color) {
 // ============================================================================
 
 // Vérifie si un coup donne échec
-int gives_check(const Board *board, const Move *move) {
-  Board temp;
-  memcpy(&temp, board, sizeof(Board));
+int gives_check(Board *board, const Move *move) {
+  // Coup joué puis annulé sur place : le plateau est rendu intact
+  UndoInfo undo;
+  make_move(board, move, &undo);
 
-  Board backup;
-  make_move_temp(&temp, move, &backup);
-
-  Couleur opponent = (temp.to_move == WHITE) ? BLACK : WHITE;
-  int in_check = is_in_check(&temp, opponent);
+  int in_check = is_in_check(board, board->to_move);
 
+  unmake_move(board, move, &undo);
   return in_check;
 }
 
 // Vérifie si un coup se dirige vers le centre
 int moves_toward_center(const Board *board, const Move *move) {
   (void)board; // Unused
-  int from_dist = square_to_center_distance(move->from);
-  int to_dist = square_to_center_distance(move->to);
+  int from_dist = square_to_center_distance(MOVE_FROM(*move));
+  int to_dist = square_to_center_distance(MOVE_TO(*move));
   return to_dist < from_dist;
 }
 
 // Vérifie si un coup est évidemment mauvais
 int is_obviously_bad_move(const Board *board, const Move *move) {
   // Un coup est mauvais s'il perd du matériel sans compensation
-  if (move->type == MOVE_CAPTURE) {
-    PieceType attacker = get_piece_type(board, move->from);
-    PieceType victim = move->captured_piece;
+  if (MOVE_TYPE(*move) == MOVE_CAPTURE) {
+    PieceType attacker = get_piece_type(board, MOVE_FROM(*move));
+    PieceType victim = move_captured_piece(board, *move);
 
     // Capturer avec une pièce de valeur supérieure est suspect
     if (piece_value(attacker) > piece_value(victim) + 100) {
       // Vérifier si la case de destination est attaquée
-      Board temp;
-      memcpy(&temp, board, sizeof(Board));
-      Board backup;
-      make_move_temp(&temp, move, &backup);
-
+      // Occupation après le coup : la pièce quitte sa case (rayons X)
+      Bitboard occupancy = board->all_pieces & ~(1ULL << MOVE_FROM(*move));
       Couleur opponent = (board->to_move == WHITE) ? BLACK : WHITE;
-      if (is_square_attacked(&temp, move->to, opponent))
+      if (attackers_to(board, MOVE_TO(*move), occupancy) &
+          board->occupied[opponent])
         return 1; // Case attaquée, coup probablement mauvais
     }
   }
@@ -182,11 +183,11 @@ int is_obviously_bad_move(const Board *board, const Move *move) {
 
 // Vérifie si un coup est une capture
 int is_capture(const Move *move) {
-  return (move->type == MOVE_CAPTURE || move->type == MOVE_EN_PASSANT);
+  return MOVE_IS_CAPTURE(*move);
 }
 
 // Vérifie si un coup est une promotion
-int is_promotion(const Move *move) { return (move->type == MOVE_PROMOTION); }
+int is_promotion(const Move *move) { return MOVE_IS_PROMOTION(*move); }
 
 // ============================================================================
 // UTILITAIRES DE PHASE DE JEU
@@ -255,11 +256,13 @@ int rank_of(Square sq) { return sq / 8; }
 // UTILITAIRES DE TEMPS ET PERFORMANCE
 // ============================================================================
 
-// Obtient le temps actuel en millisecondes
+// Obtient le temps actuel en millisecondes (horloge monotone : insensible
+// aux réglages de l'heure système, mesure le temps réel écoulé et non le
+// temps CPU)
 long get_time_ms() {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
 // Démarre un timer
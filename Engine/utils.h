@@ -37,8 +37,9 @@ int count_pieces(const Board *board, PieceType piece, Couleur color);
 // UTILITAIRES D'ANALYSE DE COUPS
 // ============================================================================
 
-// Vérifications sur les coups
-int gives_check(const Board *board, const Move *move);
+// Vérifications sur les coups (gives_check joue puis annule le coup sur
+// board, rendu intact)
+int gives_check(Board *board, const Move *move);
 int moves_toward_center(const Board *board, const Move *move);
 int is_obviously_bad_move(const Board *board, const Move *move);
 int is_capture(const Move *move);
@@ -1,8 +1,6 @@
 #include "zobrist.h"
 #include "movegen.h"
 #include <stdio.h>
-#include <time.h>
-#include <unistd.h>
 
 // Macro pour logs de debug conditionnels
 #ifdef DEBUG
@@ -12,20 +10,25 @@
 #endif
 
 // ========== TABLES ZOBRIST GLOBALES ==========
-static uint64_t zobrist_pieces[2][6][64]; // [color][piece][square]
-static uint64_t zobrist_castling[16];     // [castle_rights]
-static uint64_t zobrist_en_passant[64];   // [square]
-static uint64_t zobrist_side_to_move;     // Joueur actuel
+uint64_t zobrist_pieces[2][6][64]; // [color][piece][square]
+uint64_t zobrist_castling[16];     // [castle_rights]
+uint64_t zobrist_en_passant[64];   // [square]
+uint64_t zobrist_side_to_move;     // Joueur actuel
 
 // ========== GÉNÉRATEUR DE NOMBRES ALÉATOIRES ==========
 
+// Graine du générateur (toute valeur non nulle)
+#define ZOBRIST_SEED 0x9E3779B97F4A7C15ULL
+
 // Générateur Xorshift* (rapide et de bonne qualité)
 static uint64_t random_uint64(void) {
   static uint64_t seed = 0;
 
-  // Initialiser le seed UNE SEULE FOIS avec timestamp + PID
+  // Graine fixe : les mêmes clés à chaque exécution, donc les mêmes index
+  // de table de transposition et une recherche reproductible (signature
+  // du bench)
   if (seed == 0) {
-    seed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 16);
+    seed = ZOBRIST_SEED;
 
     // Warm-up du générateur (important pour la qualité)
     for (int i = 0; i < 64; i++) {
@@ -46,6 +49,12 @@ static uint64_t random_uint64(void) {
 // ========== INITIALISATION ZOBRIST ==========
 
 void init_zobrist(void) {
+  // Les clés ne doivent jamais changer une fois des positions hachées
+  static int initialized = 0;
+  if (initialized)
+    return;
+  initialized = 1;
+
   // Initialiser les clés pour chaque pièce sur chaque case
   for (int color = 0; color < 2; color++) {
     for (int piece = 0; piece < 6; piece++) {
@@ -126,7 +135,7 @@ uint64_t zobrist_hash(const Board *board) {
   // En passant (vérifier borne)
   if (board->en_passant >= 0 && board->en_passant < 64) {
     hash ^= zobrist_en_passant[board->en_passant];
-  } else if (board->en_passant != -1) {
+  } else if (board->en_passant != NO_SQUARE) {
     // -1 signifie pas d'en-passant; autres valeurs sont suspectes
     DEBUG_LOG("zobrist_hash: invalid en_passant=%d\n", board->en_passant);
   }
@@ -153,11 +162,14 @@ void test_zobrist_uniqueness(void) {
   DEBUG_LOG("Position initiale : hash = %016llx\n", (unsigned long long)h1);
 
   // Bouger un pion
-  Move m = {.from = E2, .to = E4, .type = MOVE_NORMAL};
-  Board backup;
-  make_move_temp(&b2, &m, &backup);
+  Move m = create_move(E2, E4, MOVE_NORMAL);
+  UndoInfo undo;
+  make_move(&b2, &m, &undo);
 
   uint64_t h2 = zobrist_hash(&b2);
+  if (b2.zobrist_key != h2) {
+    DEBUG_LOG("❌ ERREUR : clé incrémentale différente du recalcul !\n");
+  }
   DEBUG_LOG("Après e2e4      : hash = %016llx\n", (unsigned long long)h2);
 
   if (h1 == h2) {
@@ -174,5 +186,13 @@ void test_zobrist_uniqueness(void) {
     DEBUG_LOG("✓ Aucun hash nul\n");
   }
 
+  // Test 3 : unmake_move restaure la clé de départ
+  unmake_move(&b2, &m, &undo);
+  if (b2.zobrist_key != h1) {
+    DEBUG_LOG("❌ ERREUR : clé non restaurée par unmake_move !\n");
+  } else {
+    DEBUG_LOG("✓ Clé restaurée par unmake_move\n");
+  }
+
   DEBUG_LOG("=== FIN TEST ===\n\n");
 }
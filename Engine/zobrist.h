@@ -4,10 +4,18 @@
 #include "board.h"
 #include <stdint.h>
 
-// Initialise les tables Zobrist (à appeler une seule fois au démarrage)
+// Initialise les tables Zobrist (appels suivants sans effet : les clés déjà
+// stockées dans les Board restent valides)
 void init_zobrist(void);
 
-// Calcule le hash Zobrist d'une position donnée
+// Clés Zobrist (lecture directe pour la mise à jour incrémentale)
+extern uint64_t zobrist_pieces[2][6][64]; // [color][piece][square]
+extern uint64_t zobrist_castling[16];     // [castle_rights]
+extern uint64_t zobrist_en_passant[64];   // [square]
+extern uint64_t zobrist_side_to_move;     // Joueur actuel
+
+// Calcule le hash Zobrist d'une position donnée (recalcul complet : sert à
+// initialiser Board.zobrist_key et à la vérifier en debug)
 uint64_t zobrist_hash(const Board *board);
 
 // Test de validation de l'unicité des hash (debug)
@@ -177,6 +177,57 @@ test_perft "n1n5/1Pk5/8/8/8/8/5Kp1/5N1N b - - 0 1" 4 124608 "Knights + pawns com
 test_perft "8/PPPk4/8/8/8/8/4Kppp/8 b - - 0 1" 4 79355 "Symmetric pawn barrier (black)"
 test_perft "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1" 4 182838 "Symmetric pawns with knights (black)"
 
+# Perft multi-thread : le détail par coup doit être identique au perft
+# séquentiel
+test_perft_threads() {
+    local fen="$1"
+    local depth=$2
+    local threads=$3
+    local description="$4"
+
+    echo -n "Test: $description (depth $depth, $threads threads)... "
+
+    single=$(echo -e "position fen $fen\nperft $depth 1\nquit" | timeout 60 $ENGINE 2>/dev/null | grep -v "^info")
+    multi=$(echo -e "position fen $fen\nperft $depth $threads\nquit" | timeout 60 $ENGINE 2>/dev/null | grep -v "^info")
+
+    if [ -n "$single" ] && [ "$single" = "$multi" ]; then
+        echo -e "${GREEN}✅ PASS${NC} ($(echo "$multi" | tail -1))"
+        ((PASSED++))
+    else
+        echo -e "${RED}❌ FAIL${NC} (détail par coup différent)"
+        ((FAILED++))
+    fi
+}
+
+test_perft_threads "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1" 4 4 "Initial position"
+test_perft_threads "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1" 3 3 "Kiwipete position"
+test_perft_threads "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1" 5 8 "Rook endgame"
+
+# Perft avec table de hachage : 1 MB seulement pour forcer les
+# remplacements, le total doit rester exact
+test_perft_hash() {
+    local fen="$1"
+    local depth=$2
+    local expected=$3
+    local description="$4"
+
+    echo -n "Test: $description (depth $depth, hash 1 MB)... "
+
+    result=$(echo -e "position fen $fen\ngo perft $depth 2 1\nquit" | timeout 60 $ENGINE 2>/dev/null | grep "Nodes:" | tail -1 | awk '{print $2}' || echo "0")
+
+    if [ "$result" = "$expected" ]; then
+        echo -e "${GREEN}✅ PASS${NC} (Nodes: $result)"
+        ((PASSED++))
+    else
+        echo -e "${RED}❌ FAIL${NC} (Expected: $expected, Got: $result)"
+        ((FAILED++))
+    fi
+}
+
+test_perft_hash "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1" 5 4865609 "Initial position"
+test_perft_hash "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1" 4 4085603 "Kiwipete position"
+test_perft_hash "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1" 5 674624 "Rook endgame"
+
 echo ""
 echo "=========================================="
 echo "          RÉSULTATS FINAUX"
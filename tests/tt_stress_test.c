@@ -0,0 +1,146 @@
+// Test de charge de la table de transposition partagée (sans verrou)
+//
+// Plusieurs threads écrivent et sondent en boucle un petit ensemble de
+// positions qui tombent toutes dans une poignée de clusters. Les données de
+// chaque position sont déterminées par sa clé : une sonde qui renvoie autre
+// chose est une corruption non détectée (doit rester à 0). Les entrées
+// déchirées vues dans la table (clé XOR données invalide) sont comptées
+// comme corruptions détectées : tt_probe les ignore.
+//
+// Usage : tt_stress_test [threads] [secondes]
+
+#include "transposition.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define KEY_COUNT 4096 // Positions testées (indice dans les 16 bits bas)
+#define HOT_CLUSTERS 16 // Clusters visés (bits hauts de la clé)
+
+static TranspositionTable tt;
+static atomic_int stop_flag;
+static atomic_long probes, hits, stores, undetected, torn;
+
+static uint64_t mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Clé de la position i : les 14 bits hauts donnent le cluster d'une table
+// de 1 MB (16384 clusters), i est dans les 16 bits bas (permet de vérifier
+// une clé lue dans la table)
+static uint64_t key_of(int i) {
+  return ((uint64_t)(i % HOT_CLUSTERS) << 58) |
+         (mix64(i + 1) & 0x0000FFFFFFFF0000ULL) | (uint64_t)i;
+}
+
+static int is_valid_key(uint64_t key) {
+  uint64_t i = key & 0xFFFF;
+  return i < KEY_COUNT && key == key_of((int)i);
+}
+
+// Données attendues pour la position i
+static void expected_of(int i, TTData *out) {
+  uint64_t h = mix64((uint64_t)i * 0x9E3779B97F4A7C15ULL);
+  out->best_move = (Move)((h >> 8) | 1); // Jamais MOVE_NONE
+  out->score = (int)(h % 2000) - 1000;
+  out->eval = (int)((h >> 16) % 2000) - 1000;
+  out->depth = 1 + (int)((h >> 24) % 60);
+  out->type = (TTEntryType)(h % 3);
+  out->is_pv = (int)((h >> 32) & 1);
+}
+
+// Entrées déchirées actuellement présentes dans les clusters visés
+static long count_torn_entries(void) {
+  long count = 0;
+  for (int c = 0; c < HOT_CLUSTERS; c++) {
+    uint64_t key = key_of(c);
+    TTCluster *cluster =
+        &tt.clusters[((__uint128_t)key * tt.cluster_count) >> 64];
+    for (int e = 0; e < TT_CLUSTER_SIZE; e++) {
+      uint64_t data = atomic_load_explicit(&cluster->entry[e].data,
+                                           memory_order_relaxed);
+      uint64_t key_xor_data = atomic_load_explicit(
+          &cluster->entry[e].key_xor_data, memory_order_relaxed);
+      if (data != 0 && !is_valid_key(key_xor_data ^ data))
+        count++;
+    }
+  }
+  return count;
+}
+
+static void *worker(void *arg) {
+  uint64_t rng = mix64((uint64_t)(size_t)arg + 1);
+  long local_probes = 0, local_hits = 0, local_stores = 0;
+  long local_undetected = 0, local_torn = 0;
+
+  while (!atomic_load_explicit(&stop_flag, memory_order_relaxed)) {
+    for (int n = 0; n < 4096; n++) {
+      rng = mix64(rng);
+      int i = (int)(rng % KEY_COUNT);
+      TTData expected;
+      expected_of(i, &expected);
+
+      if (rng & (1ULL << 40)) {
+        tt_store(&tt, key_of(i), expected.depth, expected.score,
+                 expected.type, expected.best_move, expected.eval,
+                 expected.is_pv, 0);
+        local_stores++;
+      } else {
+        TTData got;
+        local_probes++;
+        if (tt_probe(&tt, key_of(i), 0, &got)) {
+          local_hits++;
+          if (got.best_move != expected.best_move ||
+              got.score != expected.score || got.eval != expected.eval ||
+              got.depth != expected.depth || got.type != expected.type ||
+              got.is_pv != expected.is_pv)
+            local_undetected++;
+        }
+      }
+    }
+    local_torn += count_torn_entries();
+  }
+
+  atomic_fetch_add(&probes, local_probes);
+  atomic_fetch_add(&hits, local_hits);
+  atomic_fetch_add(&stores, local_stores);
+  atomic_fetch_add(&undetected, local_undetected);
+  atomic_fetch_add(&torn, local_torn);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  int thread_count = argc > 1 ? atoi(argv[1]) : 8;
+  int seconds = argc > 2 ? atoi(argv[2]) : 2;
+  if (thread_count < 1 || thread_count > 256 || seconds < 1) {
+    fprintf(stderr, "Usage : %s [threads 1-256] [secondes]\n", argv[0]);
+    return 2;
+  }
+
+  tt_init(&tt);
+  tt_resize(&tt, 1);
+
+  pthread_t threads[256];
+  for (int t = 0; t < thread_count; t++)
+    pthread_create(&threads[t], NULL, worker, (void *)(size_t)t);
+
+  struct timespec duration = {seconds, 0};
+  nanosleep(&duration, NULL);
+  atomic_store(&stop_flag, 1);
+  for (int t = 0; t < thread_count; t++)
+    pthread_join(threads[t], NULL);
+
+  printf("threads=%d stores=%ld probes=%ld hits=%ld\n", thread_count,
+         atomic_load(&stores), atomic_load(&probes), atomic_load(&hits));
+  printf("detected=%ld undetected=%ld\n", atomic_load(&torn),
+         atomic_load(&undetected));
+
+  return (atomic_load(&undetected) == 0 && atomic_load(&hits) > 0) ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+#!/bin/bash
+# Test de charge de la table de transposition partagée entre threads
+# Vérifie qu'aucune sonde ne renvoie les données d'une autre position
+# (les entrées déchirées doivent être détectées et ignorées)
+
+# Ne pas arrêter sur erreur (on gère nous-mêmes les erreurs de test)
+set +e
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+THREADS=${1:-8}
+SECONDS_PER_RUN=${2:-2}
+BINARY="$(mktemp -d)/tt_stress_test"
+
+echo "=========================================="
+echo "   TT STRESS TEST - Chess Engine"
+echo "=========================================="
+echo ""
+
+# Compilation du banc de test avec le module de la table uniquement
+if ! gcc -O2 -std=c11 -pthread -IEngine tests/tt_stress_test.c \
+    Engine/transposition.c -o "$BINARY"; then
+    echo -e "${RED}❌ Erreur: compilation du test impossible${NC}"
+    echo "Lancez le script depuis la racine du dépôt"
+    exit 1
+fi
+
+echo -n "Test: $THREADS threads pendant ${SECONDS_PER_RUN}s... "
+output=$("$BINARY" "$THREADS" "$SECONDS_PER_RUN")
+status=$?
+rm -rf "$(dirname "$BINARY")"
+
+if [ $status -eq 0 ]; then
+    echo -e "${GREEN}✅ PASS${NC}"
+else
+    echo -e "${RED}❌ FAIL${NC}"
+fi
+echo "$output"
+exit $status
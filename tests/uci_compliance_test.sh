@@ -2,7 +2,7 @@
 # Test de conformité UCI pour ChessEngine v2.0
 # Teste les nouvelles fonctionnalités implémentées
 
-ENGINE="./chess_engine"
+export ENGINE="./chess_engine" # Exporté : utilisé dans les sous-shells bash -c
 TIMEOUT=3
 
 echo "=== Test de conformité UCI ==="
@@ -138,6 +138,20 @@ else
 fi
 echo
 
+# Test 10: bench (signature de noeuds reproductible)
+echo "Test 10: bench 4"
+first=$(timeout $TIMEOUT $ENGINE bench 4 2>/dev/null | grep "Nodes searched")
+second=$(timeout $TIMEOUT bash -c 'cat <<EOF | $ENGINE
+bench 4
+quit
+EOF' 2>/dev/null | grep "Nodes searched")
+if [ -n "$first" ] && [ "$first" = "$second" ]; then
+    echo "✅ bench reproductible ($first)"
+else
+    echo "❌ bench non reproductible ($first / $second)"
+fi
+echo
+
 echo "=== Résumé ==="
 echo "Toutes les nouvelles fonctionnalités UCI ont été testées."
 echo "Le moteur est maintenant conforme à la spécification UCI."